@@ -0,0 +1,1129 @@
+#define _DEFAULT_SOURCE
+#include "batch.h"
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#define HUGE_PAGE (2 << 20)
+#define STREAM_BUFFER (1 << 20)
+#define WORKER_ARENA (64 << 10)
+
+extern const char ERROR[];
+
+/**
+ * @brief           Range of one input file solved by one worker.
+ */
+struct shard {
+    /** path of the input */
+    const char *input;
+    /** index of the input in the job */
+    int file;
+    /** offset of the input in the concatenation of the merged inputs */
+    off_t base;
+    off_t start;
+    off_t end;
+    char *part;
+    long done;
+    long skip;
+    int restarts;
+    pid_t pid;
+};
+
+/**
+ * @brief           Input files of a batch and their shards.
+ */
+struct job {
+    const char *output;
+    char **paths;
+    int files;
+    /** offset of each input in the concatenation of the merged inputs */
+    off_t *bases;
+    struct shard *shards;
+    int count;
+};
+
+/**
+ * @brief           Parse the record into the board, in numeric or candidate
+ *                  format, and mark its unknown cells.
+ *
+ * @param board     the board
+ * @param record    the input line without newline
+ * @param length    length of the record
+ * 
+ * @return          record holds a sudoku -> true
+ *                  otherwise -> false
+ */
+bool batch_board_load(struct batch_board *board, const char *record, size_t length)
+{
+    board->unsolved[0] = board->unsolved[1] = 0;
+    board->parsed = parse_line(record, length, board->sudoku) || parse_candidates(record, length, board->sudoku);
+    for (int i = 0; board->parsed && i < 81; i++) {
+        unsigned int digits = ((unsigned int *) board->sudoku)[i];
+        if ((digits & (digits - 1)) != 0) {
+            board->unsolved[i / 64] |= 1ULL << (i % 64);
+        }
+    }
+    return board->parsed;
+}
+
+/**
+ * @brief           Return microseconds elapsed since the start.
+ *
+ * @param start     the start
+ * 
+ * @return          elapsed microseconds
+ */
+static unsigned long elapsed_microseconds(const struct timespec *start)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (unsigned long) ((now.tv_sec - start->tv_sec) * 1000000L + (now.tv_nsec - start->tv_nsec) / 1000);
+}
+
+/**
+ * @brief           Format the output line of the record which was not
+ *                  solved.
+ *
+ * @param result    metadata of the record
+ * @param format    format of the output
+ * @param line      array for the output line
+ * 
+ * @return          length of the output line
+ */
+static size_t batch_error_line(const struct result *result, enum batch_format format, char line[RESULT_LINE])
+{
+    if (format == BATCH_FORMAT_JSONL) {
+        return format_result(result, NULL, line);
+    }
+    memcpy(line, ERROR, strlen(ERROR));
+    return strlen(ERROR);
+}
+
+/**
+ * @brief           Solve the loaded board by the search of the options and
+ *                  format its output line. Boards without unknown cells are
+ *                  only checked, JSON lines are timed.
+ *
+ * @param board     board loaded by <batch_board_load()>
+ * @param options   options of the batch
+ * @param line      array for the output line
+ * 
+ * @return          length of the output line
+ */
+size_t batch_board_solve(struct batch_board *board, const struct batch_options *options, char line[RESULT_LINE])
+{
+    const struct search_options defaults = { 0 };
+    struct search_options search = options->search != NULL ? *options->search : defaults;
+    struct result result = { .id = board->id, .status = RESULT_INVALID };
+    struct timespec start;
+    search.nodes = &result.nodes;
+    if (options->format == BATCH_FORMAT_JSONL) {
+        clock_gettime(CLOCK_MONOTONIC, &start);
+    }
+    if (board->parsed && (board->unsolved[0] | board->unsolved[1]) != 0) {
+        result.status = search_solve(board->sudoku, &search) ? RESULT_SOLVED : RESULT_UNSOLVABLE;
+        if (result.status == RESULT_UNSOLVABLE && search.budget != 0 && result.nodes > search.budget) {
+            result.status = RESULT_FAILED;
+        }
+    } else if (board->parsed) {
+        result.status = is_valid(board->sudoku) ? RESULT_SOLVED : RESULT_UNSOLVABLE;
+    }
+    if (options->format == BATCH_FORMAT_JSONL) {
+        result.microseconds = elapsed_microseconds(&start);
+        return format_result(&result, board->sudoku, line);
+    }
+    if (result.status != RESULT_SOLVED) {
+        return batch_error_line(&result, options->format, line);
+    }
+    format_line(board->sudoku, line);
+    return 82;
+}
+
+/**
+ * @brief           Solve one record and format its output line.
+ *
+ * @param record    the input line without newline
+ * @param length    length of the record
+ * @param search    options of the search, NULL for defaults
+ * @param line      array for the output line
+ * 
+ * @return          length of the output line
+ */
+size_t batch_solve_record(const char *record, size_t length, const struct search_options *search, char line[82])
+{
+    const struct batch_options lines = { .search = search };
+    struct batch_board board;
+    char buffer[RESULT_LINE];
+    batch_board_load(&board, record, length);
+    size_t size = batch_board_solve(&board, &lines, buffer);
+    memcpy(line, buffer, size);
+    return size;
+}
+
+/**
+ * @brief           Hint the cache to fetch the record following the one
+ *                  in the reader block, a hint past the block is dropped.
+ *
+ * @param record    the current record without newline
+ * @param length    length of the record
+ * 
+ * @return          None
+ */
+static void record_prefetch(const char *record, size_t length)
+{
+#if defined(__GNUC__)
+    __builtin_prefetch(record + length + 1, 0);
+    __builtin_prefetch(record + length + 1 + 81, 0);
+#else
+    (void) record;
+    (void) length;
+#endif
+}
+
+/**
+ * @brief           Map anonymous memory aligned to huge pages, backed by
+ *                  the requested pages or regular ones as a fallback.
+ *
+ * @param size      size of the memory, multiple of HUGE_PAGE
+ * @param pages     requested pages
+ * 
+ * @return          the memory, NULL if out of memory
+ */
+static void *huge_alloc(size_t size, enum batch_pages pages)
+{
+    char *memory;
+#ifdef MAP_HUGETLB
+    if (pages == BATCH_PAGES_EXPLICIT) {
+        memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (memory != MAP_FAILED) {
+            return memory;
+        }
+    }
+#endif
+    memory = mmap(NULL, size + HUGE_PAGE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+        return NULL;
+    }
+    size_t head = (HUGE_PAGE - (size_t) ((uintptr_t) memory % HUGE_PAGE)) % HUGE_PAGE;
+    if (head > 0) {
+        munmap(memory, head);
+    }
+    munmap(memory + head + size, HUGE_PAGE - head);
+    memory += head;
+#ifdef MADV_HUGEPAGE
+    if (pages != BATCH_PAGES_DEFAULT) {
+        madvise(memory, size, MADV_HUGEPAGE);
+    }
+#endif
+    return memory;
+}
+
+/**
+ * @brief           Return the first offset at or after <pos> which starts
+ *                  a line.
+ *
+ * @param fd        descriptor of the input
+ * @param pos       the offset
+ * @param size      size of the input
+ * 
+ * @return          offset of the line start, <size> if there is none
+ */
+static off_t line_start(int fd, off_t pos, off_t size)
+{
+    char buffer[4096];
+    if (pos == 0) {
+        return 0;
+    }
+    for (pos--; pos < size;) {
+        ssize_t got = pread(fd, buffer, sizeof(buffer), pos);
+        if (got <= 0) {
+            return size;
+        }
+        char *newline = memchr(buffer, '\n', (size_t) got);
+        if (newline != NULL) {
+            return pos + (newline - buffer) + 1;
+        }
+        pos += got;
+    }
+    return size;
+}
+
+/**
+ * @brief           Cut the segment after its last complete line.
+ *
+ * @param path      path of the segment
+ * 
+ * @return          count of complete lines, -1 on I/O error
+ */
+static long segment_trim(const char *path)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        return 0;
+    }
+    long lines = 0;
+    off_t complete = 0, offset = 0;
+    char buffer[1 << 16];
+    size_t got;
+    while ((got = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        for (size_t i = 0; i < got; i++) {
+            if (buffer[i] == '\n') {
+                lines++;
+                complete = offset + (off_t) i + 1;
+            }
+        }
+        offset += (off_t) got;
+    }
+    fclose(file);
+    return truncate(path, complete) == 0 ? lines : -1;
+}
+
+/**
+ * @brief           Body of the worker process, solves its shard and writes
+ *                  the segment. Records are parsed a window ahead, so
+ *                  the reader and parser loops run apart from the
+ *                  search, and the next record in the reader block is
+ *                  prefetched while the current one is parsed. The search states come from the arena of the
+ *                  worker, reset for every record. The boards, the arena
+ *                  and the output buffer share one huge page if
+ *                  requested. Records before <shard->done> are already
+ *                  in the segment, record <shard->skip> gets the error line,
+ *                  which is flushed at once so the next restart gets past it.
+ *
+ * @param shard     the shard
+ * @param options   options of the batch
+ * @param progress  shared slot for the index of the record being solved
+ * 
+ * @return          exit status of the worker
+ */
+static int batch_worker(const struct shard *shard, const struct batch_options *options, volatile long *progress)
+{
+    struct reader_options reading = options->reader;
+    reading.pages = (enum reader_pages) options->pages;
+    struct reader *in = reader_open(shard->input, shard->start, shard->end, &reading);
+    FILE *out = fopen(shard->part, "ab");
+    if (in == NULL || out == NULL) {
+        return EXIT_FAILURE;
+    }
+    struct batch_board window[BATCH_WINDOW], *boards = window;
+    unsigned char memory[WORKER_ARENA];
+    struct arena arena;
+    arena_init(&arena, memory, sizeof(memory));
+    char *scratch = options->pages != BATCH_PAGES_DEFAULT ? huge_alloc(HUGE_PAGE, options->pages) : NULL;
+    if (scratch != NULL) {
+        boards = (struct batch_board *) scratch;
+        arena_init(&arena, scratch + sizeof(window), HUGE_PAGE - STREAM_BUFFER - sizeof(window));
+        setvbuf(out, scratch + HUGE_PAGE - STREAM_BUFFER, _IOFBF, STREAM_BUFFER);
+    }
+    const struct search_options defaults = { 0 };
+    struct search_options search = options->search != NULL ? *options->search : defaults;
+    struct batch_options worker = *options;
+    search.arena = &arena;
+    worker.search = &search;
+    const char *record;
+    char line[RESULT_LINE];
+    size_t length;
+    time_t flushed = time(NULL);
+    long index = 0;
+    bool more = true;
+    while (more) {
+        int count = 0;
+        while (count < BATCH_WINDOW && (more = reader_next(in, &record, &length))) {
+            record_prefetch(record, length);
+            if (index >= shard->done) {
+                boards[count].index = index;
+                boards[count].id = (unsigned long long) (shard->base + reader_offset(in));
+                batch_board_load(&boards[count++], record, length);
+            }
+            index++;
+        }
+        for (int i = 0; i < count; i++) {
+            size_t size;
+            *progress = boards[i].index;
+            if (boards[i].index == shard->skip) {
+                const struct result failed = { .id = boards[i].id, .status = RESULT_FAILED };
+                size = batch_error_line(&failed, options->format, line);
+            } else {
+                arena_reset(&arena);
+                alarm(options->timeout);
+                size = batch_board_solve(&boards[i], &worker, line);
+                alarm(0);
+            }
+            if (fwrite(line, 1, size, out) != size) {
+                return EXIT_FAILURE;
+            }
+            if (boards[i].index == shard->skip
+                || (options->checkpoint > 0 && time(NULL) - flushed >= options->checkpoint)) {
+                if (fflush(out) != 0) {
+                    return EXIT_FAILURE;
+                }
+                flushed = time(NULL);
+            }
+        }
+    }
+    int status = !reader_failed(in) && fclose(out) == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    reader_close(in);
+    if (scratch != NULL) {
+        munmap(scratch, HUGE_PAGE);
+    }
+    return status;
+}
+
+/**
+ * @brief           Fork the worker of the shard.
+ *
+ * @param shard     the shard
+ * @param options   options of the batch
+ * @param progress  shared slot of the worker
+ * 
+ * @return          worker has been started -> true
+ *                  otherwise -> false
+ */
+static bool batch_spawn(struct shard *shard, const struct batch_options *options, volatile long *progress)
+{
+    fflush(NULL);
+    *progress = -1;
+    shard->pid = fork();
+    if (shard->pid == 0) {
+        _exit(batch_worker(shard, options, progress));
+    }
+    return shard->pid > 0;
+}
+
+/**
+ * @brief           Return the file name of the path.
+ *
+ * @param path      the path
+ * 
+ * @return          part of the path after the last '/'
+ */
+static const char *base_name(const char *path)
+{
+    const char *name = strrchr(path, '/');
+    return name != NULL ? name + 1 : path;
+}
+
+/**
+ * @brief           Open the file named after the input of the shard in the
+ *                  output directory.
+ *
+ * @param job       the job
+ * @param shard     the shard
+ * 
+ * @return          the output, NULL on error
+ */
+static FILE *batch_open_output(const struct job *job, const struct shard *shard)
+{
+    const char *name = base_name(shard->input);
+    char *path = malloc(strlen(job->output) + strlen(name) + 2);
+    FILE *file = NULL;
+    if (path != NULL) {
+        sprintf(path, "%s/%s", job->output, name);
+        file = fopen(path, "wb");
+    }
+    free(path);
+    return file;
+}
+
+/**
+ * @brief           Append the segments to the outputs in order and remove
+ *                  them.
+ *
+ * @param job       the job
+ * @param options   options of the batch
+ * 
+ * @return          has been successfully joined -> true
+ *                  otherwise -> false
+ */
+static bool batch_join(const struct job *job, const struct batch_options *options)
+{
+    char *buffer = huge_alloc(HUGE_PAGE, options->pages);
+    FILE *out = NULL;
+    bool success = buffer != NULL;
+    if (options->per_file) {
+        success = success && (mkdir(job->output, 0777) == 0 || errno == EEXIST);
+    } else {
+        out = fopen(job->output, "wb");
+        success = success && out != NULL;
+    }
+    for (int i = 0; i < job->count && success; i++) {
+        const struct shard *shard = &job->shards[i];
+        if (options->per_file && (i == 0 || shard->file != job->shards[i - 1].file)) {
+            success = out == NULL || fclose(out) == 0;
+            out = batch_open_output(job, shard);
+            success = success && out != NULL;
+        }
+        FILE *part = success ? fopen(shard->part, "rb") : NULL;
+        size_t got;
+        success = part != NULL;
+        while (success && (got = fread(buffer, 1, HUGE_PAGE, part)) > 0) {
+            success = fwrite(buffer, 1, got, out) == got;
+        }
+        if (part != NULL) {
+            fclose(part);
+        }
+        remove(shard->part);
+    }
+    if (buffer != NULL) {
+        munmap(buffer, HUGE_PAGE);
+    }
+    if (out != NULL && fclose(out) != 0) {
+        success = false;
+    }
+    return success;
+}
+
+/**
+ * @brief           Set up the shard and the path of its segment.
+ *
+ * @param job       the job
+ * @param index     index of the shard
+ * @param file      index of the input
+ * @param start     offset of the first line of the shard
+ * @param end       offset after the last line of the shard
+ * 
+ * @return          has been successfully set up -> true
+ *                  otherwise -> false
+ */
+static bool shard_init(struct job *job, int index, int file, off_t start, off_t end)
+{
+    struct shard *shard = &job->shards[index];
+    shard->input = job->paths[file];
+    shard->file = file;
+    shard->base = job->bases[file];
+    shard->start = start;
+    shard->end = end < start ? start : end;
+    shard->done = 0;
+    shard->skip = -1;
+    shard->restarts = 0;
+    shard->pid = -1;
+    shard->part = malloc(strlen(job->output) + 16);
+    if (shard->part == NULL) {
+        return false;
+    }
+    sprintf(shard->part, "%s.part%d", job->output, index);
+    return true;
+}
+
+/**
+ * @brief           Make room for the next shard of the job.
+ *
+ * @param job       the job
+ * @param capacity  allocated count of shards
+ * 
+ * @return          there is room -> true
+ *                  otherwise -> false
+ */
+static bool shard_reserve(struct job *job, int *capacity)
+{
+    if (job->count < *capacity) {
+        return true;
+    }
+    int grown = *capacity == 0 ? 16 : *capacity * 2;
+    struct shard *shards = realloc(job->shards, grown * sizeof(struct shard));
+    if (shards == NULL) {
+        return false;
+    }
+    memset(shards + *capacity, 0, (grown - *capacity) * sizeof(struct shard));
+    job->shards = shards;
+    *capacity = grown;
+    return true;
+}
+
+/**
+ * @brief           Split the inputs into shards with their segment paths.
+ *                  Inputs of about the size of the whole job divided by the
+ *                  workers get one shard, larger ones are cut at lines.
+ *
+ * @param job       the job, its inputs are set
+ * @param workers   count of the workers
+ * 
+ * @return          inputs have been split -> true
+ *                  otherwise -> false
+ */
+static bool batch_split(struct job *job, int workers)
+{
+    off_t total = job->files > 0 ? job->bases[job->files] : 0;
+    off_t chunk = total / workers + 1;
+    int capacity = 0;
+    bool success = true;
+    for (int file = 0; file < job->files && success; file++) {
+        struct stat info;
+        int fd = open(job->paths[file], O_RDONLY);
+        success = fd >= 0 && fstat(fd, &info) == 0;
+        int pieces = success ? (int) (info.st_size / chunk) + 1 : 0;
+        pieces = pieces > workers ? workers : pieces;
+        off_t start = 0;
+        for (int i = 0; i < pieces && success; i++) {
+            off_t end = (i == pieces - 1) ? info.st_size
+                                          : line_start(fd, info.st_size / pieces * (i + 1), info.st_size);
+            success = shard_reserve(job, &capacity) && shard_init(job, job->count, file, start, end);
+            if (success) {
+                remove(job->shards[job->count].part);
+                start = job->shards[job->count++].end;
+            }
+        }
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+    return success;
+}
+
+/**
+ * @brief           Order the paths by name.
+ *
+ * @param first     pointer to the first path
+ * @param second    pointer to the second path
+ * 
+ * @return          result of strcmp() of the paths
+ */
+static int compare_paths(const void *first, const void *second)
+{
+    return strcmp(*(char *const *) first, *(char *const *) second);
+}
+
+/**
+ * @brief           Append the path to the inputs of the job.
+ *
+ * @param job       the job
+ * @param capacity  allocated count of paths
+ * @param directory directory of the file, NULL if <name> is the path
+ * @param name      name of the file
+ * 
+ * @return          has been appended -> true
+ *                  otherwise -> false
+ */
+static bool job_append(struct job *job, int *capacity, const char *directory, const char *name)
+{
+    if (job->files == *capacity) {
+        int grown = *capacity == 0 ? 16 : *capacity * 2;
+        char **paths = realloc(job->paths, grown * sizeof(char *));
+        if (paths == NULL) {
+            return false;
+        }
+        job->paths = paths;
+        *capacity = grown;
+    }
+    char *path = malloc((directory != NULL ? strlen(directory) + 1 : 0) + strlen(name) + 1);
+    if (path == NULL) {
+        return false;
+    }
+    if (directory != NULL) {
+        sprintf(path, "%s/%s", directory, name);
+    } else {
+        strcpy(path, name);
+    }
+    job->paths[job->files++] = path;
+    return true;
+}
+
+/**
+ * @brief           Collect the input files of the job, directories are
+ *                  replaced by their regular files ordered by name. Hidden
+ *                  files are skipped.
+ *
+ * @param job       the job
+ * @param inputs    paths of the inputs
+ * @param count     count of the inputs
+ * 
+ * @return          inputs have been collected -> true
+ *                  otherwise -> false
+ */
+static bool job_collect(struct job *job, const char *const inputs[], int count)
+{
+    int capacity = 0;
+    bool success = true;
+    for (int i = 0; i < count && success; i++) {
+        struct stat info;
+        DIR *directory = stat(inputs[i], &info) == 0 && S_ISDIR(info.st_mode) ? opendir(inputs[i]) : NULL;
+        if (directory == NULL) {
+            success = job_append(job, &capacity, NULL, inputs[i]);
+            continue;
+        }
+        int first = job->files;
+        struct dirent *entry;
+        while (success && (entry = readdir(directory)) != NULL) {
+            if (entry->d_name[0] == '.') {
+                continue;
+            }
+            success = job_append(job, &capacity, inputs[i], entry->d_name);
+            if (success && (stat(job->paths[job->files - 1], &info) != 0 || !S_ISREG(info.st_mode))) {
+                free(job->paths[--job->files]);
+            }
+        }
+        closedir(directory);
+        qsort(job->paths + first, (size_t) (job->files - first), sizeof(char *), compare_paths);
+    }
+    return success;
+}
+
+/**
+ * @brief           Compute offsets of the inputs and the header of the
+ *                  checkpoint identifying the job, with the timeout and
+ *                  search settings its results depend on.
+ *
+ * @param job       the job, its inputs are set
+ * @param workers   count of the workers
+ * @param options   options of the batch
+ * @param header    array for the header
+ * 
+ * @return          all inputs exist -> true
+ *                  otherwise -> false
+ */
+static bool job_measure(struct job *job, int workers, const struct batch_options *options, char header[256])
+{
+    long long latest = 0;
+    job->bases = malloc((job->files + 1) * sizeof(off_t));
+    if (job->bases == NULL) {
+        return false;
+    }
+    job->bases[0] = 0;
+    for (int file = 0; file < job->files; file++) {
+        struct stat info;
+        if (stat(job->paths[file], &info) != 0) {
+            return false;
+        }
+        job->bases[file + 1] = job->bases[file] + info.st_size;
+        latest = (long long) info.st_mtime > latest ? (long long) info.st_mtime : latest;
+    }
+    int length = sprintf(header, "batch %d %lld %lld %d %d %d %u", job->files, (long long) job->bases[job->files],
+                         latest, workers, (int) options->format, (int) options->per_file, options->timeout);
+    const struct search_options *search = options->search;
+    if (search != NULL) {
+        sprintf(header + length, " search %d %d %d %lu %u %lu", (int) search->fewest_candidates,
+                (int) search->value_order, (int) search->restart, search->restart_nodes, search->seed, search->budget);
+    }
+    /* merged inputs keep their offsets in the concatenation, per-file ones count ids from their own start */
+    for (int file = 0; options->per_file && file < job->files; file++) {
+        job->bases[file] = 0;
+    }
+    return true;
+}
+
+/**
+ * @brief           Check that no two inputs of the job would write the same
+ *                  file of the output directory.
+ *
+ * @param job       the job, its inputs are set
+ * 
+ * @return          file names of the inputs are distinct -> true
+ *                  otherwise -> false
+ */
+static bool job_names_unique(const struct job *job)
+{
+    const char **names = malloc((job->files + 1) * sizeof(char *));
+    bool unique = names != NULL;
+    for (int file = 0; unique && file < job->files; file++) {
+        names[file] = base_name(job->paths[file]);
+    }
+    if (unique) {
+        qsort(names, (size_t) job->files, sizeof(char *), compare_paths);
+    }
+    for (int file = 1; unique && file < job->files; file++) {
+        unique = strcmp(names[file - 1], names[file]) != 0;
+    }
+    free(names);
+    return unique;
+}
+
+/**
+ * @brief           Release the job, removing its segments unless they are
+ *                  kept for a resume.
+ *
+ * @param job       the job
+ * @param keep      keep the segments
+ * 
+ * @return          None
+ */
+static void job_free(struct job *job, bool keep)
+{
+    for (int i = 0; i < job->count; i++) {
+        if (job->shards[i].part != NULL && !keep) {
+            remove(job->shards[i].part);
+        }
+        free(job->shards[i].part);
+    }
+    for (int file = 0; file < job->files; file++) {
+        free(job->paths[file]);
+    }
+    free(job->shards);
+    free(job->paths);
+    free(job->bases);
+}
+
+/* ************************************************************** *
+ *                          Checkpoints                           *
+ * ************************************************************** */
+
+/**
+ * @brief           Return path of the checkpoint of the output.
+ *
+ * @param output    path of the output
+ * 
+ * @return          allocated path, NULL if out of memory
+ */
+static char *checkpoint_path(const char *output)
+{
+    char *path = malloc(strlen(output) + 12);
+    if (path != NULL) {
+        sprintf(path, "%s.checkpoint", output);
+    }
+    return path;
+}
+
+/**
+ * @brief           Write the checkpoint atomically, through a temporary
+ *                  file renamed over the old checkpoint.
+ *
+ * @param output    path of the output
+ * @param header    first line of the checkpoint
+ * @param job       job of the shards to be stored, may be NULL
+ * 
+ * @return          has been successfully written -> true
+ *                  otherwise -> false
+ */
+static bool checkpoint_save(const char *output, const char *header, const struct job *job)
+{
+    char *path = checkpoint_path(output);
+    char *temporary = path != NULL ? malloc(strlen(path) + 5) : NULL;
+    FILE *file = NULL;
+    bool success = temporary != NULL;
+    if (success) {
+        sprintf(temporary, "%s.tmp", path);
+        file = fopen(temporary, "w");
+        success = file != NULL && fprintf(file, "%s\n%d\n", header, job != NULL ? job->count : 0) > 0;
+    }
+    for (int i = 0; job != NULL && i < job->count && success; i++) {
+        const struct shard *shard = &job->shards[i];
+        success = fprintf(file, "%d %lld %lld\n", shard->file, (long long) shard->start, (long long) shard->end) > 0;
+    }
+    if (file != NULL && fclose(file) != 0) {
+        success = false;
+    }
+    success = success && rename(temporary, path) == 0;
+    free(temporary);
+    free(path);
+    return success;
+}
+
+/**
+ * @brief           Read the checkpoint if it belongs to the same job.
+ *
+ * @param output    path of the output
+ * @param header    expected first line of the checkpoint
+ * @param job       job for the shards, its inputs are set; may be NULL
+ * 
+ * @return          checkpoint of the job has been read -> true
+ *                  otherwise -> false
+ */
+static bool checkpoint_load(const char *output, const char *header, struct job *job)
+{
+    char *path = checkpoint_path(output);
+    FILE *file = path != NULL ? fopen(path, "r") : NULL;
+    char line[512];
+    int count = 0, capacity = 0;
+    bool success = file != NULL && fgets(line, sizeof(line), file) != NULL;
+    success = success && strncmp(line, header, strlen(header)) == 0 && line[strlen(header)] == '\n';
+    success = success && fscanf(file, "%d", &count) == 1 && count >= 0;
+    for (int i = 0; job != NULL && i < count && success; i++) {
+        long long start, end;
+        int input;
+        success = fscanf(file, "%d %lld %lld", &input, &start, &end) == 3 && input >= 0 && input < job->files
+                  && shard_reserve(job, &capacity) && shard_init(job, i, input, (off_t) start, (off_t) end);
+        if (success) {
+            job->count++;
+            job->shards[i].done = segment_trim(job->shards[i].part);
+            success = job->shards[i].done >= 0;
+        }
+    }
+    if (file != NULL) {
+        fclose(file);
+    }
+    free(path);
+    return success;
+}
+
+/**
+ * @brief           Remove the checkpoint of the finished job.
+ *
+ * @param output    path of the output
+ * 
+ * @return          None
+ */
+static void checkpoint_remove(const char *output)
+{
+    char *path = checkpoint_path(output);
+    if (path != NULL) {
+        remove(path);
+    }
+    free(path);
+}
+
+/* ************************************************************** *
+ *                          Batch jobs                            *
+ * ************************************************************** */
+
+/**
+ * @brief           Wait until one of the running workers exits and reap
+ *                  it. Only the workers are reaped, other children of the
+ *                  process are left to their owner: when some other child
+ *                  has exited, the workers are polled instead.
+ *
+ * @param job       the job
+ * @param started   count of shards which have been started
+ * @param status    set to the status of the worker
+ * 
+ * @return          index of the shard of the worker, -1 on error
+ */
+static int batch_wait(const struct job *job, int started, int *status)
+{
+    const struct timespec pause = { 0, 10 * 1000 * 1000 };
+    for (;;) {
+        for (int i = 0; i < started; i++) {
+            if (job->shards[i].pid <= 0) {
+                continue;
+            }
+            pid_t pid = waitpid(job->shards[i].pid, status, WNOHANG);
+            if (pid == job->shards[i].pid) {
+                return i;
+            }
+            if (pid < 0 && errno != EINTR) {
+                return -1;
+            }
+        }
+        /* block until some child exits, without reaping it */
+        siginfo_t info;
+        info.si_pid = 0;
+        if (waitid(P_ALL, 0, &info, WEXITED | WNOWAIT) < 0 && errno != EINTR) {
+            return -1;
+        }
+        int i = 0;
+        while (i < started && job->shards[i].pid != info.si_pid) {
+            i++;
+        }
+        if (i == started && info.si_pid != 0) {
+            nanosleep(&pause, NULL);
+        }
+    }
+}
+
+/**
+ * @brief           Solve the sudokus of the input files by forked workers.
+ *                  The shards wait in the order of the inputs, a worker is
+ *                  forked for the next one whenever fewer than <workers>
+ *                  are running.
+ *
+ * @param inputs    paths of the inputs, files or directories
+ * @param count     count of the inputs
+ * @param output    path of the output file or directory
+ * @param options   options of the batch, NULL for defaults
+ * 
+ * @return          all has been solved and written -> true
+ *                  otherwise -> false
+ */
+bool batch_solve_files(const char *const inputs[], int count, const char *output, const struct batch_options *options)
+{
+    const struct batch_options defaults = { 0 };
+    options = options != NULL ? options : &defaults;
+    int workers = options->workers > 0 ? options->workers : (int) sysconf(_SC_NPROCESSORS_ONLN);
+    workers = workers > 0 ? workers : 1;
+
+    struct job job = { .output = output };
+    char header[256];
+    bool success = job_collect(&job, inputs, count) && job_measure(&job, workers, options, header)
+                   && (!options->per_file || job_names_unique(&job));
+    if (success && !(options->resume && checkpoint_load(output, header, &job))) {
+        for (int i = 0; i < job.count; i++) {
+            free(job.shards[i].part);
+        }
+        free(job.shards);
+        job.shards = NULL;
+        job.count = 0;
+        success = batch_split(&job, workers);
+        success = success && (options->checkpoint == 0 || checkpoint_save(output, header, &job));
+    }
+    volatile long *progress = MAP_FAILED;
+    if (success && job.count > 0) {
+        progress = mmap(NULL, job.count * sizeof(long), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        success = progress != MAP_FAILED;
+    }
+
+    int running = 0, next = 0;
+    while (success || running > 0) {
+        while (success && running < workers && next < job.count) {
+            success = batch_spawn(&job.shards[next], options, &progress[next]);
+            running += success;
+            next++;
+        }
+        if (running == 0) {
+            break;
+        }
+        int status;
+        int i = batch_wait(&job, next, &status);
+        if (i < 0) {
+            success = false;
+            break;
+        }
+        struct shard *shard = &job.shards[i];
+        running--;
+        shard->pid = -1;
+        if (!WIFSIGNALED(status)) {
+            success = success && WEXITSTATUS(status) == EXIT_SUCCESS;
+            continue;
+        }
+        /* crashed or timed out, continue after the record being solved */
+        long done = segment_trim(shard->part);
+        if (!success || done < 0 || progress[i] < done || ++shard->restarts > 1000) {
+            success = false;
+            continue;
+        }
+        shard->done = done;
+        shard->skip = progress[i];
+        if (!batch_spawn(shard, options, &progress[i])) {
+            success = false;
+            continue;
+        }
+        running++;
+    }
+    success = success && batch_join(&job, options);
+    if (success) {
+        checkpoint_remove(output);
+    }
+
+    if (progress != MAP_FAILED) {
+        munmap((void *) progress, job.count * sizeof(long));
+    }
+    job_free(&job, options->checkpoint > 0);
+    if (!success) {
+        fprintf(stderr, ERROR);
+    }
+    return success;
+}
+
+/**
+ * @brief           Solve the sudokus of the input file by forked workers.
+ *
+ * @param input     path of the input
+ * @param output    path of the output
+ * @param options   options of the batch, NULL for defaults
+ * 
+ * @return          all has been solved and written -> true
+ *                  otherwise -> false
+ */
+bool batch_solve_file(const char *input, const char *output, const struct batch_options *options)
+{
+    return batch_solve_files(&input, 1, output, options);
+}
+
+/**
+ * @brief           Write the sudokus from the index-th on into the stream.
+ *                  The i-th sudoku depends only on <seed> + i.
+ *
+ * @param out       the stream
+ * @param index     index of the first sudoku
+ * @param count     count of all sudokus
+ * @param seed      seed of the job
+ * @param checkpoint seconds between flushes, 0 for none
+ * 
+ * @return          all has been written -> true
+ *                  otherwise -> false
+ */
+static bool generate_lines(FILE *out, unsigned long index, unsigned long count, unsigned int seed,
+                           unsigned int checkpoint)
+{
+    bool success = true;
+    time_t flushed = time(NULL);
+    for (; index < count && success; index++) {
+        const struct search_options random = { .restart = SEARCH_RESTART_LUBY, .seed = seed + (unsigned int) index };
+        unsigned int sudoku[9][9];
+        char line[82];
+        for (int i = 0; i < 81; i++) {
+            ((unsigned int *) sudoku)[i] = 0x1ff;
+        }
+        search_solve(sudoku, &random);
+        srand(seed + (unsigned int) index);
+        generate(sudoku);
+        format_line(sudoku, line);
+        success = fwrite(line, 1, sizeof(line), out) == sizeof(line);
+        if (success && checkpoint > 0 && time(NULL) - flushed >= checkpoint) {
+            success = fflush(out) == 0;
+            flushed = time(NULL);
+        }
+    }
+    return success;
+}
+
+/**
+ * @brief           Generate sudokus into the output file, one per line.
+ *                  The i-th sudoku depends only on <seed> + i, so the state
+ *                  of the generator is just the count of lines written.
+ *
+ * @param output    path of the output
+ * @param count     count of the sudokus
+ * @param seed      seed of the job
+ * @param options   options of the batch, NULL for defaults
+ * 
+ * @return          all has been written -> true
+ *                  otherwise -> false
+ */
+bool batch_generate_file(const char *output, unsigned long count, unsigned int seed,
+                         const struct batch_options *options)
+{
+    const struct batch_options defaults = { 0 };
+    options = options != NULL ? options : &defaults;
+    char header[128];
+    sprintf(header, "generate %u %lu", seed, count);
+
+    long done = 0;
+    if (options->resume && checkpoint_load(output, header, NULL)) {
+        done = segment_trim(output);
+    } else {
+        FILE *empty = fopen(output, "wb");
+        done = (empty != NULL && fclose(empty) == 0) ? 0 : -1;
+        if (done == 0 && options->checkpoint > 0 && !checkpoint_save(output, header, NULL)) {
+            done = -1;
+        }
+    }
+    FILE *out = done >= 0 ? fopen(output, "ab") : NULL;
+    bool success = out != NULL && generate_lines(out, (unsigned long) done, count, seed, options->checkpoint);
+    if (out != NULL && fclose(out) != 0) {
+        success = false;
+    }
+    if (success) {
+        checkpoint_remove(output);
+    } else {
+        fprintf(stderr, ERROR);
+    }
+    return success;
+}
+
+/**
+ * @brief           Generate sudokus into the open stream, one per line,
+ *                  the same ones as <batch_generate_file()>.
+ *
+ * @param out       the stream, it is flushed but not closed
+ * @param count     count of the sudokus
+ * @param seed      seed of the job
+ * 
+ * @return          all has been written -> true
+ *                  otherwise -> false
+ */
+bool batch_generate_stream(FILE *out, unsigned long count, unsigned int seed)
+{
+    bool success = generate_lines(out, 0, count, seed, 0) && fflush(out) == 0;
+    if (!success) {
+        fprintf(stderr, ERROR);
+    }
+    return success;
+}
@@ -0,0 +1,211 @@
+/**
+ * @file batch.h
+ * @brief Batch solving of large files of sudokus, one per line.
+ *
+ * Every input line holds a sudoku in numeric format (see parse_line())
+ * or in candidate format (see parse_candidates()).
+ * For every line one output line is written in the same order, either
+ * the 81 digits of the solution or the error message.
+ */
+
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "reader.h"
+#include "sudoku.h"
+
+/**
+ * @brief Pages backing the stream buffers, boards and read blocks of the
+ * workers, the same values as enum reader_pages.
+ */
+enum batch_pages {
+    /** regular pages */
+    BATCH_PAGES_DEFAULT = READER_PAGES_DEFAULT,
+    /** transparent huge pages requested by madvise() */
+    BATCH_PAGES_TRANSPARENT = READER_PAGES_TRANSPARENT,
+    /** explicit huge pages by MAP_HUGETLB, transparent ones if none are reserved */
+    BATCH_PAGES_EXPLICIT = READER_PAGES_EXPLICIT
+};
+
+/**
+ * @brief Formats of the output lines.
+ */
+enum batch_format {
+    /** the solution digits or the error message */
+    BATCH_FORMAT_LINES = 0,
+    /** one JSON object per record, see format_result(); the id is the
+     * offset of the record in its input, in the concatenation of the
+     * inputs when they are merged */
+    BATCH_FORMAT_JSONL
+};
+
+/**
+ * @brief Options of the batch driver, zero initialized options are valid.
+ */
+struct batch_options {
+    /** count of worker processes, 0 for one per online CPU */
+    int workers;
+    /** seconds allowed for one sudoku, 0 for unlimited */
+    unsigned int timeout;
+    /** options of the search, NULL for generic_solve() */
+    const struct search_options *search;
+    /** seconds between flushes of the outputs, 0 disables the checkpoints */
+    unsigned int checkpoint;
+    /** continue the job from its checkpoint, if there is one of the same
+     * inputs, layout, timeout and search settings */
+    bool resume;
+    /** pages of the buffers, falls back to regular ones when unavailable */
+    enum batch_pages pages;
+    /** backend of the input reader, its pages are set by <pages> */
+    struct reader_options reader;
+    /** format of the output lines */
+    enum batch_format format;
+    /** output is a directory with one file per input, named as the input */
+    bool per_file;
+};
+
+/** count of records parsed ahead by a worker */
+#define BATCH_WINDOW 16
+
+#if defined(__GNUC__)
+#define BATCH_ALIGNED __attribute__((aligned(64)))
+#else
+#define BATCH_ALIGNED
+#endif
+
+/**
+ * @brief Board of the batch mode, aligned to cache lines.
+ *
+ * The small hot fields share the first cache line, the candidates
+ * start at the second one and span the next six lines, so no board
+ * straddles the lines of its neighbours in an array.
+ */
+struct batch_board {
+    /** unknown squares, bit i % 64 of unsolved[i / 64] */
+    unsigned long long unsolved[2];
+    /** index of the record within its shard */
+    long index;
+    /** identifier of the record in the output */
+    unsigned long long id;
+    /** record holds a valid sudoku */
+    bool parsed;
+    /** 2D array of digit bitsets */
+    unsigned int sudoku[9][9] BATCH_ALIGNED;
+} BATCH_ALIGNED;
+
+/**
+ * @brief Parse the record into the board.
+ *
+ * @param board to be loaded
+ * @param record the input line without newline
+ * @param length of the record
+ *
+ * @return true if the record holds a valid sudoku.
+ */
+bool batch_board_load(struct batch_board *board, const char *record, size_t length);
+
+/**
+ * @brief Solve the loaded board and format its output line.
+ *
+ * @param board loaded by batch_board_load()
+ * @param options of the batch, only search and format are used
+ * @param line RESULT_LINE chars of output (82 suffice for lines format),
+ * not null terminated
+ *
+ * @return length of the output line.
+ */
+size_t batch_board_solve(struct batch_board *board, const struct batch_options *options, char line[RESULT_LINE]);
+
+/**
+ * @brief Solve one record and format its output line.
+ *
+ * @param record the input line without newline
+ * @param length of the record
+ * @param search options of the search, NULL for defaults
+ * @param line 82 chars of output, not null terminated
+ *
+ * @return length of the output line.
+ */
+size_t batch_solve_record(const char *record, size_t length, const struct search_options *search, char line[82]);
+
+/**
+ * @brief Solve all sudokus of the input file in forked worker processes.
+ *
+ * The input is split into byte ranges aligned to lines, one per worker.
+ * Each worker writes its own segment (output path with ".partN" suffix),
+ * the segments are joined into the output in the input order at the end.
+ * A worker which crashes or exceeds the timeout is restarted after the
+ * record it was solving, the record gets the error line.
+ *
+ * With checkpoints the shards are stored in "<output>.checkpoint" and
+ * the segments are kept on failure, flushed at least every checkpoint
+ * seconds. A resumed job with the same input and count of workers only
+ * solves the records missing in the segments.
+ *
+ * @param input path of the input file
+ * @param output path of the output file
+ * @param options of the batch, NULL for defaults
+ *
+ * @return false on I/O error, in such case one line message is printed
+ * on STDERR.
+ */
+bool batch_solve_file(const char *input, const char *output, const struct batch_options *options);
+
+/**
+ * @brief Solve all sudokus of the input files in forked worker processes.
+ *
+ * Directories among the inputs stand for their regular files in order of
+ * names, hidden files are skipped. Small inputs make one shard each,
+ * inputs larger than the total size per worker are split into up to
+ * workers shards, and at most workers shards are solved at once, the
+ * next one starting when a worker finishes. Restarts and checkpoints
+ * work as in batch_solve_file().
+ *
+ * The results of all inputs are merged into the output in the order of
+ * the inputs, or with options->per_file the output is a directory (made
+ * when missing) with the results of each input in a file of its name.
+ * Inputs with the same file name fail the job before anything is solved.
+ *
+ * @param inputs paths of the input files or directories
+ * @param count of the inputs
+ * @param output path of the output file or directory
+ * @param options of the batch, NULL for defaults
+ *
+ * @return false on I/O error, in such case one line message is printed
+ * on STDERR.
+ */
+bool batch_solve_files(const char *const inputs[], int count, const char *output,
+                       const struct batch_options *options);
+
+/**
+ * @brief Generate sudokus into the output file, one per line.
+ *
+ * The i-th sudoku is generated by generate() from a random solution,
+ * both seeded with seed + i, so the job is reproducible and its
+ * generator state is just the count of lines written.
+ *
+ * @param output path of the output file
+ * @param count of the sudokus
+ * @param seed of the job
+ * @param options of the batch, only checkpoint and resume are used
+ *
+ * @return false on I/O error, in such case one line message is printed
+ * on STDERR.
+ */
+bool batch_generate_file(const char *output, unsigned long count, unsigned int seed,
+                         const struct batch_options *options);
+
+/**
+ * @brief Generate the same sudokus as batch_generate_file() into the
+ * stream, e.g. stdout, without checkpoints.
+ *
+ * @param out stream to write to, flushed but not closed
+ * @param count of the sudokus
+ * @param seed of the job
+ *
+ * @return false on I/O error, in such case one line message is printed
+ * on STDERR.
+ */
+bool batch_generate_stream(FILE *out, unsigned long count, unsigned int seed);
+
+#endif //BATCH_H
@@ -0,0 +1,543 @@
+#define _POSIX_C_SOURCE 200809L
+#include "batch.h"
+#include "reader.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+extern const char ERROR[];
+
+static const char USAGE[] =
+    "usage: sudoku <command> [options] [input...]\n"
+    "\n"
+    "commands:\n"
+    "  solve [input...]           solve one puzzle per line, inputs may be\n"
+    "                             directories of files\n"
+    "  generate -n count          generate puzzles, one per line\n"
+    "  validate [puzzles [solutions]]\n"
+    "                             check puzzles, or submitted solutions\n"
+    "  count [input]              count solutions of each puzzle\n"
+    "  bench [input]              measure the solving speed\n"
+    "\n"
+    "options:\n"
+    "  -j workers   worker processes of solve with -o and input files, 0 for\n"
+    "               one per CPU\n"
+    "  -t seconds   time allowed for one puzzle of solve with -o\n"
+    "  -b guesses   guesses allowed for one puzzle, 0 for unlimited\n"
+    "  -f format    output of solve, lines (default) or jsonl\n"
+    "  -o output    output file, default STDOUT\n"
+    "  -P           solve writes one file per input into the -o directory\n"
+    "  -c seconds   checkpoint interval of solve and generate with -o\n"
+    "  -R           resume the job from its checkpoint\n"
+    "  -u           read the input by io_uring\n"
+    "  -d           read the input by O_DIRECT\n"
+    "  -H pages     back the buffers by huge pages, transparent or explicit\n"
+    "  -n count     count of puzzles to generate\n"
+    "  -s seed      seed of generate\n"
+    "  -l limit     solutions counted per puzzle, 0 for unlimited\n"
+    "  -r repeats   rounds of bench\n"
+    "\n"
+    "Input is a file or '-' for STDIN (default), one puzzle of 81 digits\n"
+    "per line, '0' or '.' for unknown. STDIN is solved only on its own.\n";
+
+/**
+ * @brief           Options of the command line.
+ */
+struct cli {
+    struct batch_options batch;
+    /** -j is given */
+    bool workers;
+    struct search_options search;
+    const char *output;
+    unsigned long count;
+    unsigned int seed;
+    unsigned long limit;
+    unsigned int repeats;
+};
+
+/* ************************************************************** *
+ *                            Helpers                             *
+ * ************************************************************** */
+
+/**
+ * @brief           Parse the unsigned number of an option.
+ *
+ * @param text      the argument of the option
+ * @param value     set to the number
+ *
+ * @return          the whole argument is a number -> true
+ *                  otherwise -> false
+ */
+static bool parse_number(const char *text, unsigned long *value)
+{
+    char *end;
+    *value = strtoul(text, &end, 10);
+    return *text != '\0' && *text != '-' && *end == '\0';
+}
+
+/**
+ * @brief           Parse the options following the command.
+ *
+ * @param cli       options to be set
+ * @param argc      count of the arguments, the command first
+ * @param argv      the arguments
+ *
+ * @return          index of the first operand, -1 on invalid option
+ */
+static int parse_options(struct cli *cli, int argc, char *argv[])
+{
+    unsigned long value = 0;
+    int option;
+    optind = 1;
+    while ((option = getopt(argc, argv, "j:t:b:f:o:c:RPudn:s:l:r:H:")) != -1) {
+        bool valid = true;
+        switch (option) {
+        case 'f':
+            valid = strcmp(optarg, "lines") == 0 || strcmp(optarg, "jsonl") == 0;
+            cli->batch.format = strcmp(optarg, "jsonl") == 0 ? BATCH_FORMAT_JSONL : BATCH_FORMAT_LINES;
+            break;
+        case 'o':
+            cli->output = optarg;
+            break;
+        case 'R':
+            cli->batch.resume = true;
+            break;
+        case 'P':
+            cli->batch.per_file = true;
+            break;
+        case 'u':
+            cli->batch.reader.uring = true;
+            break;
+        case 'd':
+            cli->batch.reader.direct = true;
+            break;
+        case 'H':
+            valid = strcmp(optarg, "transparent") == 0 || strcmp(optarg, "explicit") == 0;
+            cli->batch.pages = strcmp(optarg, "explicit") == 0 ? BATCH_PAGES_EXPLICIT : BATCH_PAGES_TRANSPARENT;
+            break;
+        case '?':
+            return -1;
+        default:
+            valid = parse_number(optarg, &value);
+            break;
+        }
+        if (!valid) {
+            return -1;
+        }
+        switch (option) {
+        case 'j':
+            cli->batch.workers = (int) value;
+            cli->workers = true;
+            break;
+        case 't':
+            cli->batch.timeout = (unsigned int) value;
+            break;
+        case 'b':
+            cli->search.budget = value;
+            break;
+        case 'c':
+            cli->batch.checkpoint = (unsigned int) value;
+            break;
+        case 'n':
+            cli->count = value;
+            break;
+        case 's':
+            cli->seed = (unsigned int) value;
+            break;
+        case 'l':
+            cli->limit = value;
+            break;
+        case 'r':
+            cli->repeats = (unsigned int) value;
+            break;
+        default:
+            break;
+        }
+    }
+    return optind;
+}
+
+/**
+ * @brief           Open the lines of the input.
+ *
+ * @param cli       options of the command line
+ * @param input     path of the input, "-" for STDIN
+ *
+ * @return          the reader, NULL on error (reported on STDERR)
+ */
+static struct reader *open_input(const struct cli *cli, const char *input)
+{
+    struct reader_options reading = cli->batch.reader;
+    reading.pages = (enum reader_pages) cli->batch.pages;
+    struct reader *reader = reader_open(input, 0, -1, &reading);
+    if (reader == NULL) {
+        fprintf(stderr, ERROR);
+    }
+    return reader;
+}
+
+/**
+ * @brief           Close the input and report its I/O error.
+ *
+ * @param reader    the reader
+ *
+ * @return          no I/O error has occurred -> true
+ *                  otherwise -> false
+ */
+static bool close_input(struct reader *reader)
+{
+    bool success = !reader_failed(reader);
+    reader_close(reader);
+    if (!success) {
+        fprintf(stderr, ERROR);
+    }
+    return success;
+}
+
+/**
+ * @brief           Return seconds elapsed since the start.
+ *
+ * @param start     the start
+ *
+ * @return          elapsed seconds
+ */
+static double elapsed_seconds(const struct timespec *start)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double) (now.tv_sec - start->tv_sec) + (double) (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+/* ************************************************************** *
+ *                            Commands                            *
+ * ************************************************************** */
+
+/**
+ * @brief           Solve the puzzles of the input one by one in this
+ *                  process and write them to STDOUT.
+ *
+ * @param cli       options of the command line
+ * @param input     path of the input
+ *
+ * @return          exit status
+ */
+static int solve_stream(const struct cli *cli, const char *input)
+{
+    struct reader *reader = open_input(cli, input);
+    if (reader == NULL) {
+        return EXIT_FAILURE;
+    }
+    const char *record;
+    size_t length;
+    char line[RESULT_LINE];
+    bool success = true;
+    while (success && reader_next(reader, &record, &length)) {
+        struct batch_board board;
+        board.id = (unsigned long long) reader_offset(reader);
+        batch_board_load(&board, record, length);
+        size_t size = batch_board_solve(&board, &cli->batch, line);
+        success = fwrite(line, 1, size, stdout) == size;
+    }
+    success = close_input(reader) && success;
+    return success && fflush(stdout) == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ * @brief           Solve the puzzles, by forked workers if the inputs and
+ *                  the output are files, otherwise the inputs one after
+ *                  another. STDIN among other inputs and workers without
+ *                  the forked ones are rejected.
+ *
+ * @param cli       options of the command line
+ * @param inputs    paths of the inputs
+ * @param count     count of the inputs
+ *
+ * @return          exit status, 2 on usage error
+ */
+static int command_solve(const struct cli *cli, char *const inputs[], int count)
+{
+    bool standard = false;
+    for (int i = 0; i < count; i++) {
+        standard = standard || strcmp(inputs[i], "-") == 0;
+    }
+    if (standard && count > 1) {
+        fputs("sudoku: '-' (STDIN) cannot be solved with other inputs\n", stderr);
+        return 2;
+    }
+    if (cli->workers && (standard || cli->output == NULL)) {
+        fputs("sudoku: -j needs -o and input files\n", stderr);
+        return 2;
+    }
+    if (cli->output != NULL && !standard) {
+        return batch_solve_files((const char *const *) inputs, count, cli->output, &cli->batch) ? EXIT_SUCCESS
+                                                                                                : EXIT_FAILURE;
+    }
+    if (cli->output != NULL && freopen(cli->output, "wb", stdout) == NULL) {
+        fprintf(stderr, ERROR);
+        return EXIT_FAILURE;
+    }
+    int status = EXIT_SUCCESS;
+    for (int i = 0; i < count && status == EXIT_SUCCESS; i++) {
+        status = solve_stream(cli, inputs[i]);
+    }
+    return status;
+}
+
+/**
+ * @brief           Generate the puzzles into the output file, with its
+ *                  checkpoint, or to STDOUT.
+ *
+ * @param cli       options of the command line
+ *
+ * @return          exit status
+ */
+static int command_generate(const struct cli *cli)
+{
+    bool success = cli->output != NULL ? batch_generate_file(cli->output, cli->count, cli->seed, &cli->batch)
+                                       : batch_generate_stream(stdout, cli->count, cli->seed);
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ * @brief           Check every puzzle of the input, writing "ok",
+ *                  "conflict" or "malformed" per line.
+ *
+ * @param cli       options of the command line
+ * @param input     path of the input
+ *
+ * @return          exit status, failure if some puzzle is not ok
+ */
+static int validate_puzzles(const struct cli *cli, const char *input)
+{
+    struct reader *reader = open_input(cli, input);
+    if (reader == NULL) {
+        return EXIT_FAILURE;
+    }
+    const char *record;
+    size_t length;
+    bool all = true;
+    while (reader_next(reader, &record, &length)) {
+        unsigned int sudoku[9][9];
+        const char *verdict = "ok";
+        if (!parse_line(record, length, sudoku)) {
+            verdict = "malformed";
+        } else if (!validate(sudoku, NULL)) {
+            verdict = "conflict";
+        }
+        all = all && verdict[0] == 'o';
+        puts(verdict);
+    }
+    return close_input(reader) && all ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ * @brief           Check that the record holds exactly 81 chars, optionally
+ *                  followed by '\r'.
+ *
+ * @param record    the record
+ * @param length    length of the record
+ *
+ * @return          record has the length of a sudoku -> true
+ *                  otherwise -> false
+ */
+static bool sudoku_length(const char *record, size_t length)
+{
+    return length == 81 || (length == 82 && record[81] == '\r');
+}
+
+/**
+ * @brief           Verify the submitted solutions of the puzzles in chunks,
+ *                  writing "pass", "fail" or "malformed" per line. Records
+ *                  which are not 81 chars long, including a missing
+ *                  solution, are malformed.
+ *
+ * @param cli       options of the command line
+ * @param input     path of the puzzles
+ * @param solutions path of the solutions
+ *
+ * @return          exit status, failure if some solution does not pass
+ */
+static int validate_solutions(const struct cli *cli, const char *input, const char *solutions)
+{
+    enum { CHUNK = 4096 };
+    struct reader *puzzles = open_input(cli, input);
+    struct reader *answers = puzzles != NULL ? open_input(cli, solutions) : NULL;
+    char *records = malloc(2 * CHUNK * 82);
+    unsigned char passed[CHUNK / 8];
+    bool malformed[CHUNK];
+    bool all = answers != NULL && records != NULL, more = all;
+    while (more) {
+        size_t count = 0;
+        const char *record;
+        size_t length;
+        while (count < CHUNK && (more = reader_next(puzzles, &record, &length))) {
+            char *puzzle = records + count * 82, *solution = records + (CHUNK + count) * 82;
+            malformed[count] = !sudoku_length(record, length);
+            memcpy(puzzle, record, malformed[count] ? 0 : 81);
+            if (!reader_next(answers, &record, &length)) {
+                record = NULL;
+            }
+            malformed[count] = malformed[count] || record == NULL || !sudoku_length(record, length);
+            if (malformed[count]) {
+                memset(puzzle, '0', 81);
+                memset(solution, 'x', 81);
+            } else {
+                memcpy(solution, record, 81);
+            }
+            count++;
+        }
+        verify_solutions(records, records + CHUNK * 82, 82, count, passed);
+        for (size_t i = 0; i < count; i++) {
+            bool pass = (passed[i / 8] >> (i % 8)) & 1;
+            all = all && pass;
+            puts(malformed[i] ? "malformed" : pass ? "pass" : "fail");
+        }
+    }
+    free(records);
+    bool success = (puzzles == NULL || close_input(puzzles)) && (answers == NULL || close_input(answers));
+    return success && all ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ * @brief           Count the solutions of every puzzle of the input, writing
+ *                  the count or the error message per line.
+ *
+ * @param cli       options of the command line
+ * @param input     path of the input
+ *
+ * @return          exit status
+ */
+static int command_count(const struct cli *cli, const char *input)
+{
+    struct reader *reader = open_input(cli, input);
+    if (reader == NULL) {
+        return EXIT_FAILURE;
+    }
+    const char *record;
+    size_t length;
+    while (reader_next(reader, &record, &length)) {
+        unsigned int sudoku[9][9];
+        if (parse_line(record, length, sudoku)) {
+            printf("%lu\n", enumerate_solutions(sudoku, cli->limit, NULL, NULL));
+        } else {
+            printf("%s", ERROR);
+        }
+    }
+    return close_input(reader) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ * @brief           Solve all valid puzzles of the input repeatedly and
+ *                  write the speed and average guesses.
+ *
+ * @param cli       options of the command line
+ * @param input     path of the input
+ *
+ * @return          exit status
+ */
+static int command_bench(const struct cli *cli, const char *input)
+{
+    struct reader *reader = open_input(cli, input);
+    if (reader == NULL) {
+        return EXIT_FAILURE;
+    }
+    unsigned int (*puzzles)[9][9] = NULL;
+    size_t count = 0, capacity = 0;
+    const char *record;
+    size_t length;
+    while (reader_next(reader, &record, &length)) {
+        if (count == capacity) {
+            capacity = capacity == 0 ? 1024 : capacity * 2;
+            unsigned int (*grown)[9][9] = realloc(puzzles, capacity * sizeof(*puzzles));
+            if (grown == NULL) {
+                free(puzzles);
+                reader_close(reader);
+                fprintf(stderr, ERROR);
+                return EXIT_FAILURE;
+            }
+            puzzles = grown;
+        }
+        count += parse_line(record, length, puzzles[count]);
+    }
+    if (!close_input(reader)) {
+        free(puzzles);
+        return EXIT_FAILURE;
+    }
+
+    unsigned int repeats = cli->repeats != 0 ? cli->repeats : 1;
+    unsigned long solved = 0, nodes = 0, guesses;
+    struct search_options search = cli->search;
+    struct timespec start;
+    search.nodes = &guesses;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (unsigned int round = 0; round < repeats; round++) {
+        for (size_t i = 0; i < count; i++) {
+            unsigned int sudoku[9][9];
+            memcpy(sudoku, puzzles[i], sizeof(sudoku));
+            solved += search_solve(sudoku, &search);
+            nodes += guesses;
+        }
+    }
+    double seconds = elapsed_seconds(&start);
+    double total = (double) count * repeats;
+    printf("puzzles %zu, rounds %u, solved %lu, seconds %.3f, puzzles/s %.0f, guesses/puzzle %.2f\n",
+           count, repeats, solved / repeats, seconds, seconds > 0 ? total / seconds : 0.0,
+           total > 0 ? (double) nodes / total : 0.0);
+    free(puzzles);
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief           Run the command given by the first argument with the
+ *                  options and operands following it.
+ *
+ * @param argc      count of the arguments
+ * @param argv      the arguments
+ *
+ * @return          exit status of the command, 2 on usage error
+ */
+int main(int argc, char *argv[])
+{
+    struct cli cli = { 0 };
+    if (argc < 2) {
+        fputs(USAGE, stderr);
+        return 2;
+    }
+    const char *command = argv[1];
+    int first = parse_options(&cli, argc - 1, argv + 1);
+    if (first < 0) {
+        fputs(USAGE, stderr);
+        return 2;
+    }
+    unsigned char memory[64 << 10];
+    struct arena arena;
+    arena_init(&arena, memory, sizeof(memory));
+    cli.search.arena = &arena;
+    cli.batch.search = &cli.search;
+    int operands = argc - 1 - first;
+    char **operand = argv + 1 + first;
+    char *standard[] = { "-" };
+    const char *input = operands > 0 ? operand[0] : "-";
+
+    if (strcmp(command, "solve") == 0 && !(cli.batch.per_file && cli.output == NULL)) {
+        return operands > 0 ? command_solve(&cli, operand, operands) : command_solve(&cli, standard, 1);
+    }
+    if (strcmp(command, "generate") == 0 && operands == 0) {
+        return command_generate(&cli);
+    }
+    if (strcmp(command, "validate") == 0 && operands <= 1) {
+        return validate_puzzles(&cli, input);
+    }
+    if (strcmp(command, "validate") == 0 && operands == 2) {
+        return validate_solutions(&cli, operand[0], operand[1]);
+    }
+    if (strcmp(command, "count") == 0 && operands <= 1) {
+        return command_count(&cli, input);
+    }
+    if (strcmp(command, "bench") == 0 && operands <= 1) {
+        return command_bench(&cli, input);
+    }
+    fputs(USAGE, stderr);
+    return 2;
+}
@@ -0,0 +1,173 @@
+#include "portfolio.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+const struct search_options PORTFOLIO_DEFAULT[] = {
+    { .fewest_candidates = false },
+    { .fewest_candidates = true },
+    { .fewest_candidates = true, .value_order = SEARCH_VALUE_DESCENDING },
+    { .restart = SEARCH_RESTART_LUBY, .restart_nodes = 32, .seed = 1 },
+};
+
+const int PORTFOLIO_DEFAULT_COUNT = sizeof(PORTFOLIO_DEFAULT) / sizeof(PORTFOLIO_DEFAULT[0]);
+
+/**
+ * @brief           State shared by all racing engines.
+ */
+struct race {
+    pthread_mutex_t lock;
+    bool finished;
+    int winner;
+    unsigned int solution[9][9];
+};
+
+/**
+ * @brief           One engine taking part in the race.
+ */
+struct racer {
+    struct race *race;
+    const struct search_options *engine;
+    struct search_options options;
+    unsigned long nodes;
+    int index;
+    unsigned int sudoku[9][9];
+};
+
+/**
+ * @brief           Stop callback of the racing engines.
+ *
+ * @param context   the racer
+ * 
+ * @return          race is over or the engine wants to stop -> true
+ *                  otherwise -> false
+ */
+static bool racer_stop(void *context)
+{
+    struct racer *racer = context;
+    pthread_mutex_lock(&racer->race->lock);
+    bool finished = racer->race->finished;
+    pthread_mutex_unlock(&racer->race->lock);
+    if (finished) {
+        return true;
+    }
+    return racer->engine->stop != NULL && racer->engine->stop(racer->engine->context);
+}
+
+/**
+ * @brief           Run one engine and report its result to the race. An
+ *                  engine which is stopped or runs out of its budget
+ *                  leaves the race to the others.
+ *
+ * @param context   the racer
+ * 
+ * @return          NULL
+ */
+static void *racer_run(void *context)
+{
+    struct racer *racer = context;
+    bool solved = search_solve(racer->sudoku, &racer->options);
+    /* only an exhaustive failure proves there is no solution */
+    bool exhausted = racer->options.budget != 0 && racer->nodes > racer->options.budget;
+    bool stopped = !solved && (exhausted || racer_stop(racer));
+
+    pthread_mutex_lock(&racer->race->lock);
+    if (!racer->race->finished && !stopped) {
+        racer->race->finished = true;
+        if (solved) {
+            racer->race->winner = racer->index;
+            memcpy(racer->race->solution, racer->sudoku, sizeof(racer->sudoku));
+        }
+    }
+    pthread_mutex_unlock(&racer->race->lock);
+    return NULL;
+}
+
+/**
+ * @brief           Solve the sudoku by racing several engines, the first
+ *                  finished engine cancels the others.
+ *
+ * @param sudoku    sudoku (array 9x9)
+ * @param engines   options of the searches, NULL for the default portfolio
+ * @param count     count of the engines
+ * 
+ * @return          index of the engine which found the solution,
+ *                  -1 if no solution has been found
+ */
+int portfolio_solve(unsigned int sudoku[9][9], const struct search_options engines[], int count)
+{
+    if (engines == NULL) {
+        engines = PORTFOLIO_DEFAULT;
+        count = PORTFOLIO_DEFAULT_COUNT;
+    }
+    if (count < 1) {
+        return -1;
+    }
+    struct arena *arena = engines[0].arena;
+    size_t mark = arena != NULL ? arena->used : 0;
+    struct racer *racers = arena != NULL ? arena_alloc(arena, count * sizeof(struct racer)) : NULL;
+    pthread_t *threads = racers != NULL ? arena_alloc(arena, count * sizeof(pthread_t)) : NULL;
+    bool *started = threads != NULL ? arena_alloc(arena, count * sizeof(bool)) : NULL;
+    if (started == NULL) {
+        if (arena != NULL) {
+            arena_release(arena, mark);
+        }
+        arena = NULL;
+        racers = malloc(count * sizeof(struct racer));
+        threads = malloc(count * sizeof(pthread_t));
+        started = malloc(count * sizeof(bool));
+    }
+    if (racers == NULL || threads == NULL || started == NULL) {
+        free(racers);
+        free(threads);
+        free(started);
+        return search_solve(sudoku, &engines[0]) ? 0 : -1;
+    }
+
+    struct race race = { .finished = false, .winner = -1 };
+    pthread_mutex_init(&race.lock, NULL);
+    for (int i = 0; i < count; i++) {
+        racers[i].race = &race;
+        racers[i].engine = &engines[i];
+        racers[i].options = engines[i];
+        racers[i].options.stop = racer_stop;
+        racers[i].options.context = &racers[i];
+        /* only the engine on the calling thread may use its arena */
+        racers[i].options.arena = i == 0 ? arena : NULL;
+        /* the counters of the engines may be shared, each racer counts its own */
+        racers[i].options.nodes = &racers[i].nodes;
+        racers[i].index = i;
+        started[i] = false;
+        memcpy(racers[i].sudoku, sudoku, sizeof(racers[i].sudoku));
+    }
+    for (int i = 1; i < count; i++) {
+        started[i] = pthread_create(&threads[i], NULL, racer_run, &racers[i]) == 0;
+    }
+    racer_run(&racers[0]);
+    for (int i = 1; i < count; i++) {
+        if (started[i]) {
+            pthread_join(threads[i], NULL);
+        }
+    }
+    pthread_mutex_destroy(&race.lock);
+
+    if (race.winner >= 0) {
+        memcpy(sudoku, race.solution, sizeof(race.solution));
+    }
+    for (int i = 0; i < count; i++) {
+        if (engines[i].nodes != NULL) {
+            *engines[i].nodes = 0;
+        }
+    }
+    if (race.winner >= 0 && engines[race.winner].nodes != NULL) {
+        *engines[race.winner].nodes = racers[race.winner].nodes;
+    }
+    if (arena != NULL) {
+        arena_release(arena, mark);
+    } else {
+        free(racers);
+        free(threads);
+        free(started);
+    }
+    return race.winner;
+}
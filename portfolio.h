@@ -0,0 +1,50 @@
+/**
+ * @file portfolio.h
+ * @brief Portfolio solver racing several searches on separate threads.
+ *
+ * Every engine is one configuration of the backtracking search. The engines
+ * run on the same sudoku in parallel, the first one which finishes decides
+ * the result and the rest of them are cancelled.
+ *
+ * The portfolio is only a library, the command line does not use it. It
+ * needs POSIX threads, build it with -pthread.
+ */
+
+#ifndef PORTFOLIO_H
+#define PORTFOLIO_H
+
+#include "sudoku.h"
+
+/**
+ * @brief Engines used by portfolio_solve() when none are given.
+ */
+extern const struct search_options PORTFOLIO_DEFAULT[];
+
+/**
+ * @brief Count of engines in PORTFOLIO_DEFAULT.
+ */
+extern const int PORTFOLIO_DEFAULT_COUNT;
+
+/**
+ * @brief Solve the sudoku by racing the engines against each other.
+ *
+ * The first engine runs on the calling thread, the others on their own
+ * threads. The <stop> callback and <budget> of an engine are still
+ * honoured, an engine which is stopped or runs out of its budget does not
+ * end the race. When the first engine has an arena, the racers are
+ * allocated from it and its search uses it, the other engines search on
+ * their thread stacks.
+ * Only the <nodes> counter of the winning engine gets its count of
+ * guesses, the counters of the other engines are set to 0.
+ *
+ * @param sudoku 2D array of digit bitsets, replaced by the solution
+ * @param engines options of the racing searches, NULL for PORTFOLIO_DEFAULT
+ * @param count of the engines
+ *
+ * @return index of the engine which finished first and found a solution,
+ * -1 if the sudoku has no solution or every engine was stopped or ran out
+ * of its budget.
+ */
+int portfolio_solve(unsigned int sudoku[9][9], const struct search_options engines[], int count);
+
+#endif //PORTFOLIO_H
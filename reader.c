@@ -0,0 +1,585 @@
+#define _GNU_SOURCE
+#include "reader.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/io_uring.h>
+#endif
+
+/** alignment of offsets and buffers required by O_DIRECT */
+#define DIRECT_ALIGN 4096
+/** filled size of a block which is being read */
+#define IN_FLIGHT -1
+/** size of a huge page, the blocks are aligned to it */
+#define HUGE_PAGE (2 << 20)
+/** size of all blocks, multiple of HUGE_PAGE */
+#define BLOCKS_SIZE ((size_t) READER_DEPTH * READER_BLOCK)
+
+/**
+ * @brief           Submission and completion queues of io_uring.
+ */
+struct ring {
+    int fd;
+    void *sq_ring;
+    void *cq_ring;
+    size_t sq_size;
+    size_t cq_size;
+    size_t sqes_size;
+    unsigned int *sq_tail;
+    unsigned int *sq_mask;
+    unsigned int *sq_array;
+    unsigned int *cq_head;
+    unsigned int *cq_tail;
+    unsigned int *cq_mask;
+#ifdef __NR_io_uring_setup
+    struct io_uring_sqe *sqes;
+    struct io_uring_cqe *cqes;
+#endif
+};
+
+struct reader {
+    int fd;
+    /** the ring is set up */
+    bool ring_ready;
+    /** reads are submitted to the ring */
+    bool uring;
+    bool direct;
+    /** the file is a pipe read sequentially, one block at a time */
+    bool stream;
+    bool failed;
+    bool finished;
+    /** offset after the last line, -1 for the end of the file */
+    off_t end;
+    /** offset of the next block to be read */
+    off_t next;
+    /** offset of each block, -1 if it is past the end */
+    off_t offset[READER_DEPTH];
+    /** bytes in each block, IN_FLIGHT while it is being read */
+    ssize_t filled[READER_DEPTH];
+    /** READER_DEPTH blocks of READER_BLOCK bytes */
+    char *blocks;
+    /** block of the current line */
+    int head;
+    const char *pos;
+    const char *limit;
+    /** offset of the line returned last */
+    off_t line_offset;
+    /** offset of the line in the carry */
+    off_t carry_offset;
+    /** start of a line split between blocks */
+    char *carry;
+    size_t carry_length;
+    size_t carry_capacity;
+    struct ring ring;
+};
+
+/* ************************************************************** *
+ *                             io_uring                           *
+ * ************************************************************** */
+
+#ifdef __NR_io_uring_setup
+
+/**
+ * @brief           Unmap the queues and close the ring.
+ *
+ * @param ring      the ring
+ *
+ * @return          None
+ */
+static void ring_free(struct ring *ring)
+{
+    if (ring->sq_ring != NULL && ring->sq_ring != MAP_FAILED) {
+        munmap(ring->sq_ring, ring->sq_size);
+    }
+    if (ring->cq_ring != NULL && ring->cq_ring != MAP_FAILED) {
+        munmap(ring->cq_ring, ring->cq_size);
+    }
+    if (ring->sqes != NULL && (void *) ring->sqes != MAP_FAILED) {
+        munmap(ring->sqes, ring->sqes_size);
+    }
+    close(ring->fd);
+}
+
+/**
+ * @brief           Set up the ring with the given count of entries.
+ *
+ * @param ring      the ring
+ * @param entries   count of entries
+ *
+ * @return          kernel supports io_uring -> true
+ *                  otherwise -> false
+ */
+static bool ring_init(struct ring *ring, unsigned int entries)
+{
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    memset(ring, 0, sizeof(*ring));
+    ring->fd = (int) syscall(__NR_io_uring_setup, entries, &params);
+    if (ring->fd < 0) {
+        return false;
+    }
+    ring->sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+    ring->cq_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    ring->sq_ring = mmap(NULL, ring->sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd,
+                         IORING_OFF_SQ_RING);
+    ring->cq_ring = mmap(NULL, ring->cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd,
+                         IORING_OFF_CQ_RING);
+    ring->sqes = mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd,
+                      IORING_OFF_SQES);
+    if (ring->sq_ring == MAP_FAILED || ring->cq_ring == MAP_FAILED || (void *) ring->sqes == MAP_FAILED) {
+        ring_free(ring);
+        return false;
+    }
+    ring->sq_tail = (unsigned int *) ((char *) ring->sq_ring + params.sq_off.tail);
+    ring->sq_mask = (unsigned int *) ((char *) ring->sq_ring + params.sq_off.ring_mask);
+    ring->sq_array = (unsigned int *) ((char *) ring->sq_ring + params.sq_off.array);
+    ring->cq_head = (unsigned int *) ((char *) ring->cq_ring + params.cq_off.head);
+    ring->cq_tail = (unsigned int *) ((char *) ring->cq_ring + params.cq_off.tail);
+    ring->cq_mask = (unsigned int *) ((char *) ring->cq_ring + params.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe *) ((char *) ring->cq_ring + params.cq_off.cqes);
+    return true;
+}
+
+/**
+ * @brief           Submit read of the block.
+ *
+ * @param ring      the ring
+ * @param fd        descriptor of the file
+ * @param buffer    buffer of the block
+ * @param offset    offset of the block in the file
+ * @param block     index of the block
+ *
+ * @return          read has been submitted -> true
+ *                  otherwise -> false
+ */
+static bool ring_read(struct ring *ring, int fd, char *buffer, off_t offset, int block)
+{
+    unsigned int tail = *ring->sq_tail;
+    unsigned int index = tail & *ring->sq_mask;
+    struct io_uring_sqe *sqe = &ring->sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = fd;
+    sqe->addr = (unsigned long) buffer;
+    sqe->len = READER_BLOCK;
+    sqe->off = (unsigned long long) offset;
+    sqe->user_data = (unsigned long long) block;
+    ring->sq_array[index] = index;
+    __atomic_store_n(ring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+    return syscall(__NR_io_uring_enter, ring->fd, 1, 0, 0, NULL, 0) == 1;
+}
+
+#else
+
+static void ring_free(struct ring *ring)
+{
+    (void) ring;
+}
+
+static bool ring_init(struct ring *ring, unsigned int entries)
+{
+    (void) ring;
+    (void) entries;
+    return false;
+}
+
+static bool ring_read(struct ring *ring, int fd, char *buffer, off_t offset, int block)
+{
+    (void) ring;
+    (void) fd;
+    (void) buffer;
+    (void) offset;
+    (void) block;
+    return false;
+}
+
+#endif
+
+/* ************************************************************** *
+ *                             Blocks                             *
+ * ************************************************************** */
+
+/**
+ * @brief           Read synchronously until the buffer is full or the end
+ *                  of the file, dropping O_DIRECT if the file rejects it.
+ *
+ * @param reader    the reader
+ * @param buffer    the buffer
+ * @param size      size of the buffer
+ * @param offset    offset in the file
+ *
+ * @return          count of bytes read, -1 on I/O error
+ */
+static ssize_t read_block(struct reader *reader, char *buffer, size_t size, off_t offset)
+{
+    size_t done = 0;
+    while (done < size) {
+        ssize_t got = reader->stream ? read(reader->fd, buffer + done, size - done)
+                                     : pread(reader->fd, buffer + done, size - done, offset + (off_t) done);
+        if (got < 0 && errno == EINVAL && reader->direct) {
+            reader->direct = false;
+            fcntl(reader->fd, F_SETFL, fcntl(reader->fd, F_GETFL) & ~O_DIRECT);
+            continue;
+        }
+        if (got < 0 && errno == EINTR) {
+            continue;
+        }
+        if (got < 0) {
+            return -1;
+        }
+        if (got == 0) {
+            break;
+        }
+        done += (size_t) got;
+        if (reader->stream || (reader->direct && done % DIRECT_ALIGN != 0)) {
+            break;
+        }
+    }
+    return (ssize_t) done;
+}
+
+/**
+ * @brief           Record the completed read of the block, finishing a
+ *                  short or failed read synchronously.
+ *
+ * @param reader    the reader
+ * @param block     index of the block
+ * @param result    bytes read or negative error number
+ *
+ * @return          None
+ */
+static void complete_block(struct reader *reader, int block, ssize_t result)
+{
+    char *buffer = reader->blocks + (size_t) block * READER_BLOCK;
+    if (result < 0) {
+        result = read_block(reader, buffer, READER_BLOCK, reader->offset[block]);
+    } else if (result > 0 && result < READER_BLOCK && (!reader->direct || result % DIRECT_ALIGN == 0)) {
+        ssize_t rest = read_block(reader, buffer + result, READER_BLOCK - (size_t) result,
+                                  reader->offset[block] + result);
+        result = rest < 0 ? -1 : result + rest;
+    }
+    if (result < 0) {
+        reader->failed = true;
+        result = 0;
+    }
+    reader->filled[block] = result;
+}
+
+/**
+ * @brief           Start reading the next block of the file into the block.
+ *
+ * @param reader    the reader
+ * @param block     index of the block
+ *
+ * @return          None
+ */
+static void fill_block(struct reader *reader, int block)
+{
+    if (reader->end >= 0 && reader->next >= reader->end) {
+        reader->offset[block] = -1;
+        reader->filled[block] = 0;
+        return;
+    }
+    reader->offset[block] = reader->next;
+    reader->next += READER_BLOCK;
+    reader->filled[block] = IN_FLIGHT;
+    if (reader->uring) {
+        if (ring_read(&reader->ring, reader->fd, reader->blocks + (size_t) block * READER_BLOCK,
+                      reader->offset[block], block)) {
+            return;
+        }
+        reader->uring = false;
+    }
+    complete_block(reader, block, -1);
+    if (reader->stream) {
+        reader->next = reader->offset[block] + reader->filled[block];
+    }
+}
+
+/**
+ * @brief           Wait until the block is read.
+ *
+ * @param reader    the reader
+ * @param block     index of the block
+ *
+ * @return          None
+ */
+static void wait_block(struct reader *reader, int block)
+{
+#ifdef __NR_io_uring_setup
+    struct ring *ring = &reader->ring;
+    while (reader->filled[block] == IN_FLIGHT) {
+        unsigned int head = *ring->cq_head;
+        while (head != __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE)) {
+            struct io_uring_cqe *cqe = &ring->cqes[head & *ring->cq_mask];
+            complete_block(reader, (int) cqe->user_data, cqe->res);
+            head++;
+        }
+        __atomic_store_n(ring->cq_head, head, __ATOMIC_RELEASE);
+        if (reader->filled[block] == IN_FLIGHT
+            && syscall(__NR_io_uring_enter, ring->fd, 0, 1, IORING_ENTER_GETEVENTS, NULL, 0) < 0
+            && errno != EINTR) {
+            reader->failed = true;
+            reader->filled[block] = 0;
+        }
+    }
+#else
+    (void) reader;
+    (void) block;
+#endif
+}
+
+/**
+ * @brief           Make the block the current one.
+ *
+ * @param reader    the reader
+ * @param block     index of the block
+ * @param skip      bytes to skip at the start of the block
+ *
+ * @return          block holds some data of the range -> true
+ *                  otherwise -> false
+ */
+static bool enter_block(struct reader *reader, int block, size_t skip)
+{
+    wait_block(reader, block);
+    size_t valid = (size_t) reader->filled[block];
+    if (reader->offset[block] < 0) {
+        valid = 0;
+    } else if (reader->end >= 0 && (off_t) valid > reader->end - reader->offset[block]) {
+        valid = (size_t) (reader->end - reader->offset[block]);
+    }
+    reader->head = block;
+    reader->limit = reader->blocks + (size_t) block * READER_BLOCK + valid;
+    reader->pos = reader->blocks + (size_t) block * READER_BLOCK + (skip < valid ? skip : valid);
+    return valid > 0 && !reader->failed;
+}
+
+/**
+ * @brief           Append the bytes to the split line.
+ *
+ * @param reader    the reader
+ * @param bytes     the bytes
+ * @param count     count of the bytes
+ *
+ * @return          has been appended -> true
+ *                  otherwise -> false
+ */
+static bool carry_append(struct reader *reader, const char *bytes, size_t count)
+{
+    if (reader->carry_length + count > reader->carry_capacity) {
+        size_t capacity = reader->carry_capacity == 0 ? 256 : reader->carry_capacity;
+        while (capacity < reader->carry_length + count) {
+            capacity *= 2;
+        }
+        char *carry = realloc(reader->carry, capacity);
+        if (carry == NULL) {
+            reader->failed = true;
+            return false;
+        }
+        reader->carry = carry;
+        reader->carry_capacity = capacity;
+    }
+    memcpy(reader->carry + reader->carry_length, bytes, count);
+    reader->carry_length += count;
+    return true;
+}
+
+/**
+ * @brief           Map the blocks aligned to huge pages, backed by the
+ *                  requested pages or regular ones as a fallback.
+ *
+ * @param pages     requested pages
+ * 
+ * @return          the blocks, MAP_FAILED if out of memory
+ */
+static char *blocks_alloc(enum reader_pages pages)
+{
+    char *memory;
+    if (pages == READER_PAGES_DEFAULT) {
+        return mmap(NULL, BLOCKS_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    }
+#ifdef MAP_HUGETLB
+    if (pages == READER_PAGES_EXPLICIT) {
+        memory = mmap(NULL, BLOCKS_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (memory != MAP_FAILED) {
+            return memory;
+        }
+    }
+#endif
+    memory = mmap(NULL, BLOCKS_SIZE + HUGE_PAGE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+        return memory;
+    }
+    size_t head = (HUGE_PAGE - (size_t) ((uintptr_t) memory % HUGE_PAGE)) % HUGE_PAGE;
+    if (head > 0) {
+        munmap(memory, head);
+    }
+    munmap(memory + head + BLOCKS_SIZE, HUGE_PAGE - head);
+    memory += head;
+#ifdef MADV_HUGEPAGE
+    madvise(memory, BLOCKS_SIZE, MADV_HUGEPAGE);
+#endif
+    return memory;
+}
+
+/* ************************************************************** *
+ *                             Reader                             *
+ * ************************************************************** */
+
+/**
+ * @brief           Open the reader of the lines starting in the byte range.
+ *                  Reads are aligned to O_DIRECT blocks, the bytes before
+ *                  <start> are skipped and the first READER_DEPTH blocks
+ *                  are queued at once. The blocks are mapped on the pages
+ *                  given by the options.
+ *
+ * @param path      path of the file, "-" for STDIN
+ * @param start     offset of the first line
+ * @param end       offset after the last line, -1 for the end of file
+ * @param options   options of the reader, NULL for defaults
+ * 
+ * @return          the reader, NULL on error
+ */
+struct reader *reader_open(const char *path, off_t start, off_t end, const struct reader_options *options)
+{
+    const struct reader_options defaults = { 0 };
+    options = options != NULL ? options : &defaults;
+    struct reader *reader = calloc(1, sizeof(struct reader));
+    if (reader == NULL) {
+        return NULL;
+    }
+    reader->stream = strcmp(path, "-") == 0;
+    start = reader->stream ? 0 : start;
+    end = reader->stream ? -1 : end;
+    reader->direct = options->direct && !reader->stream;
+    reader->fd = reader->direct ? open(path, O_RDONLY | O_DIRECT) : -1;
+    if (reader->fd < 0) {
+        reader->direct = false;
+        reader->fd = reader->stream ? dup(STDIN_FILENO) : open(path, O_RDONLY);
+    }
+    reader->blocks = blocks_alloc(options->pages);
+    if (reader->fd < 0 || reader->blocks == MAP_FAILED) {
+        reader->blocks = reader->blocks == MAP_FAILED ? NULL : reader->blocks;
+        reader_close(reader);
+        return NULL;
+    }
+    reader->ring_ready = options->uring && !reader->stream && ring_init(&reader->ring, READER_DEPTH);
+    reader->uring = reader->ring_ready;
+    reader->end = end;
+    reader->next = start - start % DIRECT_ALIGN;
+    for (int i = 0; i < (reader->stream ? 1 : READER_DEPTH); i++) {
+        fill_block(reader, i);
+    }
+    reader->finished = !enter_block(reader, 0, (size_t) (start % DIRECT_ALIGN));
+    return reader;
+}
+
+/**
+ * @brief           Return the next line, from the current block if it ends
+ *                  there, otherwise joined in the carry buffer across the
+ *                  following blocks.
+ *
+ * @param reader    the reader
+ * @param line      set to the line without newline
+ * @param length    set to the length of the line
+ * 
+ * @return          line has been read -> true
+ *                  end of range or I/O error -> false
+ */
+bool reader_next(struct reader *reader, const char **line, size_t *length)
+{
+    while (!reader->failed) {
+        const char *newline = reader->pos < reader->limit
+                              ? memchr(reader->pos, '\n', (size_t) (reader->limit - reader->pos)) : NULL;
+        const char *stop = newline != NULL ? newline : reader->limit;
+        off_t offset = reader->offset[reader->head]
+                       + (reader->pos - (reader->blocks + (size_t) reader->head * READER_BLOCK));
+        if (reader->carry_length == 0) {
+            reader->carry_offset = offset;
+        }
+        if (newline != NULL && reader->carry_length == 0) {
+            reader->line_offset = offset;
+            *line = reader->pos;
+            *length = (size_t) (newline - reader->pos);
+            reader->pos = newline + 1;
+            return true;
+        }
+        if (!carry_append(reader, reader->pos, (size_t) (stop - reader->pos))) {
+            return false;
+        }
+        reader->pos = stop;
+        if (newline != NULL || reader->finished) {
+            reader->pos += newline != NULL;
+            reader->line_offset = reader->carry_offset;
+            *line = reader->carry;
+            *length = reader->carry_length;
+            reader->carry_length = 0;
+            return *length > 0 || newline != NULL;
+        }
+        int block = reader->head;
+        fill_block(reader, reader->stream ? (block + 1) % READER_DEPTH : block);
+        reader->finished = !enter_block(reader, (block + 1) % READER_DEPTH, 0);
+    }
+    return false;
+}
+
+/**
+ * @brief           Return offset of the line returned last.
+ *
+ * @param reader    the reader
+ * 
+ * @return          offset of the line in the file
+ */
+off_t reader_offset(const struct reader *reader)
+{
+    return reader->line_offset;
+}
+
+/**
+ * @brief           Return whether the reader has stopped on I/O error.
+ *
+ * @param reader    the reader
+ * 
+ * @return          read has failed -> true
+ *                  otherwise -> false
+ */
+bool reader_failed(const struct reader *reader)
+{
+    return reader->failed;
+}
+
+/**
+ * @brief           Wait for the reads in flight and release the reader.
+ *
+ * @param reader    the reader, may be NULL
+ * 
+ * @return          None
+ */
+void reader_close(struct reader *reader)
+{
+    if (reader == NULL) {
+        return;
+    }
+    for (int i = 0; i < READER_DEPTH; i++) {
+        wait_block(reader, i);
+    }
+    if (reader->ring_ready) {
+        ring_free(&reader->ring);
+    }
+    if (reader->blocks != NULL) {
+        munmap(reader->blocks, BLOCKS_SIZE);
+    }
+    if (reader->fd >= 0) {
+        close(reader->fd);
+    }
+    free(reader->carry);
+    free(reader);
+}
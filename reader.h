@@ -0,0 +1,96 @@
+/**
+ * @file reader.h
+ * @brief Reading of large files of records, one per line.
+ *
+ * The reader keeps several blocks of the file in flight by io_uring
+ * and hands out the lines of the filled blocks, a line split between
+ * two blocks is joined in a separate buffer. When io_uring or O_DIRECT
+ * is not available, the blocks are read by plain read() calls.
+ */
+
+#ifndef READER_H
+#define READER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <sys/types.h>
+
+/** size of one block of the reader */
+#define READER_BLOCK (1 << 20)
+/** count of blocks in flight */
+#define READER_DEPTH 4
+
+/**
+ * @brief Pages backing the blocks of the reader.
+ */
+enum reader_pages {
+    /** regular pages */
+    READER_PAGES_DEFAULT = 0,
+    /** transparent huge pages requested by madvise() */
+    READER_PAGES_TRANSPARENT,
+    /** explicit huge pages by MAP_HUGETLB, transparent ones if none are reserved */
+    READER_PAGES_EXPLICIT
+};
+
+/**
+ * @brief Options of the reader, zero initialized options use read().
+ */
+struct reader_options {
+    /** keep READER_DEPTH reads in flight by io_uring */
+    bool uring;
+    /** bypass the page cache by O_DIRECT */
+    bool direct;
+    /** pages of the blocks, falls back to regular ones when unavailable */
+    enum reader_pages pages;
+};
+
+struct reader;
+
+/**
+ * @brief Open the lines of the file starting in the byte range.
+ *
+ * Path "-" stands for STDIN, which is read sequentially a block at a
+ * time, so it may be a pipe; the range and options are ignored then.
+ *
+ * @param path of the file
+ * @param start offset of the first line
+ * @param end offset after the last line, -1 for the end of the file
+ * @param options of the reader, NULL for defaults
+ *
+ * @return the reader, NULL on error.
+ */
+struct reader *reader_open(const char *path, off_t start, off_t end, const struct reader_options *options);
+
+/**
+ * @brief Return the next line of the reader.
+ *
+ * @param reader opened by reader_open()
+ * @param line set to the line without newline, valid until the next call
+ * @param length set to the length of the line
+ *
+ * @return false at the end of the range or on I/O error.
+ */
+bool reader_next(struct reader *reader, const char **line, size_t *length);
+
+/**
+ * @brief Return offset of the line returned last by reader_next().
+ *
+ * @param reader opened by reader_open()
+ */
+off_t reader_offset(const struct reader *reader);
+
+/**
+ * @brief Return whether the reader has stopped on I/O error.
+ *
+ * @param reader opened by reader_open()
+ */
+bool reader_failed(const struct reader *reader);
+
+/**
+ * @brief Close the reader and release its buffers.
+ *
+ * @param reader opened by reader_open(), may be NULL
+ */
+void reader_close(struct reader *reader);
+
+#endif //READER_H
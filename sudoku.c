@@ -1,16 +1,43 @@
 #include "sudoku.h"
 #include <ctype.h>
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#if defined(__unix__) || defined(__APPLE__)
+#include <errno.h>
+#include <unistd.h>
+#define INPUT_POSIX
+#endif
 
 const unsigned int NINE_ONES = 0x1ff;
 const unsigned int EMPTY_CELL = 0x00;
 const char ERROR[] = "ERROR has occurred!\n";
 
+/** size of the block read from STDIN at once */
+#define INPUT_BLOCK (1 << 20)
+
+/**
+ * @brief           Block of STDIN being parsed by <load()>.
+ */
+static struct {
+    size_t pos;
+    size_t size;
+    char data[INPUT_BLOCK];
+} input;
+
 bool contain(unsigned int original, int number);
 void copy_array(unsigned int copy_from[81], unsigned int copy_to[81]);
 static unsigned int bitset_add(unsigned int original, int number);
 static bool bitset_is_unique(unsigned int original);
 static int bitset_next(unsigned int bitset, int previous);
+static int bitset_count(unsigned int bitset);
+static bool cells_see(int first, int second);
+static int house_cell(int house, int index);
+static bool eliminate_all(unsigned int sudoku[9][9]);
+static void remove_digits(unsigned int sudoku[81], struct trail *trail, int cell, unsigned int digits);
 unsigned int make_bitset(unsigned int sudoku[9][9], int row_start, int row_end, int col_start, int col_end);
 
 /* ************************************************************** *
@@ -214,6 +241,73 @@ bool is_valid(unsigned int sudoku[9][9])
     return true;
 }
 
+/**
+ * @brief           Set bit of the cell in the 81 bit mask.
+ *
+ * @param mask      two words of the mask
+ * @param cell      index of the cell in 1D format
+ * 
+ * @return          None
+ */
+static void cell_mask_set(unsigned long long mask[2], int cell)
+{
+    mask[cell / 64] |= 1ULL << (cell % 64);
+}
+
+/**
+ * @brief           function checks all houses in one pass and reports
+ *                  conflicting cells, empty cells and digits which have
+ *                  no place left in some house.
+ *
+ * @param sudoku    sudoku in 2D format 
+ * @param report    structure for the problems found, NULL to stop
+ *                  at the first problem
+ * 
+ * @return          no problem has been found -> true
+ *                  otherwise -> false
+ */
+bool validate(unsigned int sudoku[9][9], struct validation *report)
+{
+    unsigned int *sud = (unsigned int *) sudoku;
+    bool valid = true;
+    if (report != NULL) {
+        report->conflicts[0] = report->conflicts[1] = 0;
+        report->empty[0] = report->empty[1] = 0;
+    }
+    for (int house = 0; house < 27; house++) {
+        unsigned int known = 0, duplicate = 0, possible = 0;
+        for (int i = 0; i < 9; i++) {
+            unsigned int cell = sud[house_cell(house, i)];
+            possible |= cell;
+            if (bitset_is_unique(cell)) {
+                duplicate |= known & cell;
+                known |= cell;
+            }
+        }
+        bool house_valid = duplicate == 0 && possible == NINE_ONES;
+        for (int i = 0; i < 9 && house_valid; i++) {
+            house_valid = sud[house_cell(house, i)] != EMPTY_CELL;
+        }
+        if (report == NULL && !house_valid) {
+            return false;
+        }
+        valid = valid && house_valid;
+        if (report == NULL) {
+            continue;
+        }
+        report->missing[house] = NINE_ONES & ~possible;
+        for (int i = 0; i < 9 && !house_valid; i++) {
+            int cell = house_cell(house, i);
+            if (sud[cell] == EMPTY_CELL) {
+                cell_mask_set(report->empty, cell);
+            } else if (bitset_is_unique(sud[cell]) && (sud[cell] & duplicate) != 0) {
+                cell_mask_set(report->conflicts, cell);
+            }
+        }
+    }
+    return valid;
+}
+
 /**
  * @brief           The function tries to solve the sudoku using elimination.   
  *
@@ -252,320 +346,2440 @@ bool solve(unsigned int sudoku[9][9])
     return true;
 }
 
+/* ************************************************************** *
+ *                              Trail                             *
+ * ************************************************************** */
+
 /**
- * @brief           The function tries to load row of the sudoku in 
- *                  ASCII format. Function is controlling row with "+-".    
+ * @brief           Start logging changes of the sudoku.
  *
- * @param col_index  the index from which the row is to be checked.
+ * @param trail     the trail
+ * @param sudoku    sudoku in 2D format
  * 
- * @return          has been successfully loaded 26 chars -> true
- *                  otherwise -> false
+ * @return          None
  */
-bool check_plus_minus(int col_index)
+void trail_init(struct trail *trail, unsigned int sudoku[9][9])
 {
-    const char pref[] = "+-------+-------+-------+\n";
-    int chr;
-    while (col_index < 26 && (chr = getchar()) != EOF) {
-        if (pref[col_index] != chr) {
-            return false;
-        }
-        col_index++;
-    }
-    return col_index == 26;
+    trail->sudoku = (unsigned int *) sudoku;
+    trail->size = 0;
 }
 
 /**
- * @brief           The function tries to load row of the sudoku in 
- *                  ASCII format. Function is controlling row with numbers.
- * 
- * @param row       the index of the row being checked
- * @param sudoku    sudoku in 2D format 
+ * @brief           Remove digits from the cell and log its old value.
+ *
+ * @param trail     the trail
+ * @param cell      index of the cell in 1D format
+ * @param digits    bitset of digits to be removed
  * 
- * @return          has been successfully loaded 26 chars -> true
+ * @return          cell has been changed -> true
  *                  otherwise -> false
  */
-bool check_normal_row(int row, unsigned int sudoku[9][9])
+bool trail_remove(struct trail *trail, int cell, unsigned int digits)
 {
-    int cell_pointer = 0, col = 0, chr;
-    while (cell_pointer < 25 && (chr = getchar()) != EOF) {
-        if (cell_pointer % 8 == 0) {
-            if (chr != '|') {
-                return false;
-            }
-        } else if (cell_pointer % 2 == 0) {
-            sudoku[row][col] = 0;
-            if (chr == '.' || chr == '0') {
-                sudoku[row][col] = NINE_ONES;
-            } else if (chr == '!') {
-                sudoku[row][col] = EMPTY_CELL;
-            } else if ('1' <= chr && chr <= '9') {
-                sudoku[row][col] = bitset_add(sudoku[row][col], chr - '0');
-            } else {
-                return false;
-            }
-            col++;
-        } else if (chr != ' ') {
-            return false;
-        }
-        cell_pointer++;
+    unsigned int original = trail->sudoku[cell];
+    if ((original & digits) == 0) {
+        return false;
     }
-    return (cell_pointer == 25) && (getchar() == '\n');
+    trail->entries[trail->size].cell = (unsigned char) cell;
+    trail->entries[trail->size].mask = (unsigned short) original;
+    trail->size++;
+    trail->sudoku[cell] = original & ~digits;
+    return true;
 }
 
 /**
- * @brief           The function tries to load the sudoku in ASCII format
- *                  from standard input.   
+ * @brief           Restore the sudoku to the state when the trail had
+ *                  the given size.
  *
- * @param sudoku    sudoku in 2D format 
+ * @param trail     the trail
+ * @param mark      size of the trail to return to
  * 
- * @return          has been successfully loaded 13 rows -> true
- *                  otherwise -> false
+ * @return          None
  */
-bool load_ascii_format(unsigned int sudoku[9][9])
+void trail_undo(struct trail *trail, int mark)
 {
-    int num_rows_loaded = 0, rows_loaded = 1;
-    while (rows_loaded < 13) {
-        if (rows_loaded % 4 == 0) {
-            if (!check_plus_minus(0)) {
-                return false;
-            }
-        } else {
-            if (!check_normal_row(num_rows_loaded, sudoku)) {
-                return false;
-            }
-            num_rows_loaded++;
-        }
-        rows_loaded++;
+    while (trail->size > mark) {
+        trail->size--;
+        trail->sudoku[trail->entries[trail->size].cell] = trail->entries[trail->size].mask;
     }
-    return rows_loaded == 13;
 }
 
 /**
- * @brief           The function tries to load the sudoku in numeric format
- *                  from standard input.   
+ * @brief           Remove digits from the cell, through the trail if any.
  *
- * @param sudoku    sudoku in 2D format 
+ * @param sudoku    sudoku in 1D format
+ * @param trail     trail logging the removals, may be NULL
+ * @param cell      index of the cell
+ * @param digits    bitset of digits to be removed
  * 
- * @return          has been successfully loaded -> true
- *                  otherwise -> false
+ * @return          None
  */
-bool load_numeric_format(unsigned int sudoku[81])
+static void remove_digits(unsigned int sudoku[81], struct trail *trail, int cell, unsigned int digits)
 {
-    int cell_pointer = 1, chr;
-    while (cell_pointer < 81 && (chr = getchar()) != EOF) {
-        if (!isdigit(chr)) {
-            return false;
-        }
-        sudoku[cell_pointer] = 0;
-        sudoku[cell_pointer] = (chr != '0') ? bitset_add(sudoku[cell_pointer], chr - '0') : NINE_ONES;
-        cell_pointer++;
+    if (trail != NULL) {
+        trail_remove(trail, cell, digits);
+    } else {
+        sudoku[cell] &= ~digits;
     }
-    return cell_pointer == 81 && (((chr = getchar()) == EOF) || chr == '\n');
 }
 
 /**
- * @brief           The function decides which of the two formats will 
- *                  be loaded and calls it.  
+ * @brief           Remove digits of known cells from unknown cells of all
+ *                  houses, the same as one sweep of <solve()>.
  *
- * @param sudoku    sudoku in 2D format 
+ * @param sudoku    sudoku in 1D format
+ * @param trail     trail logging the removals, may be NULL
  * 
- * @return          has been successfully loaded -> true
+ * @return          elimination has made changes -> true
  *                  otherwise -> false
  */
-bool load(unsigned int sudoku[9][9])
+static bool eliminate_houses(unsigned int sudoku[81], struct trail *trail)
 {
-    int chr = getchar();
-    if (isdigit(chr)) {
-        int num = chr - '0';
-        sudoku[0][0] = 0;
-        sudoku[0][0] = (num != 0) ? bitset_add(sudoku[0][0], num) : NINE_ONES;
-        if (load_numeric_format((unsigned int *) sudoku)) {
-            return true;
+    bool is_change = false;
+    for (int house = 0; house < 27; house++) {
+        unsigned int known = 0;
+        for (int i = 0; i < 9; i++) {
+            int cell = house_cell(house, i);
+            if (bitset_is_unique(sudoku[cell])) {
+                known |= sudoku[cell];
+            }
         }
-    }
-    if (chr == '+') {
-        if (check_plus_minus(1) && load_ascii_format(sudoku)) {
-            return true;
+        for (int i = 0; i < 9; i++) {
+            int cell = house_cell(house, i);
+            if (!bitset_is_unique(sudoku[cell]) && (sudoku[cell] & known) != 0) {
+                remove_digits(sudoku, trail, cell, known);
+                is_change = true;
+            }
         }
     }
-    fprintf(stderr, ERROR);
-    return false;
+    return is_change;
 }
 
+/* ************************************************************** *
+ *                              Arena                             *
+ * ************************************************************** */
+
 /**
- * @brief           Function print the sudoku to standard output.  
+ * @brief           Set up the arena in the given memory.
  *
- * @param sudoku    sudoku in 2D format 
+ * @param arena     the arena
+ * @param memory    memory of the arena
+ * @param size      size of the memory
  * 
  * @return          None
  */
-void print(unsigned int sudoku[9][9])
+void arena_init(struct arena *arena, void *memory, size_t size)
 {
-    char delim[] = "+-------+-------+-------+\n";
-    for (int i = 0; i < 9; i++) {
-        if (i % 3 == 0) {
-            printf("%s", delim);
-        }
-        for (int j = 0; j < 9; j++) {
-            if (j % 3 == 0) {
-                printf("| ");
-            }
-            if (sudoku[i][j] == 0) {
-                printf("! ");
-            } else if (bitset_is_unique(sudoku[i][j])) {
-                printf("%d ", bitset_next(sudoku[i][j], 0));
-            } else {
-                printf(". ");
-            }
-        }
-        printf("|\n");
-    }
-    printf("%s", delim);
+    arena->memory = memory;
+    arena->size = size;
+    arena->used = 0;
 }
 
-/* ************************************************************** *
- *                              Bonus                             *
- * ************************************************************** */
-
 /**
- * @brief           Return count of cells which can be deleted and
- *                  sudoku will be still solvable with <solve()>. Indexes
- *                  of these cells are storing in the <mask>.  
+ * @brief           Allocate the block after the used part of the arena,
+ *                  aligned to <ARENA_ALIGN> bytes.
  *
- * @param sudoku     original sudoku in 1D format
- * @param sud_copy   auxiliary array in 1D format
- * @param mask       auxiliary array in 1D format for storing indexes  
+ * @param arena     the arena
+ * @param size      size of the block
  * 
- * @return          count of cells which can be deleted and
- *                  sudoku will be still solvable with <solve()>.
+ * @return          the block, NULL if it does not fit
  */
-int is_solvable(unsigned int sudoku[81], unsigned int sud_copy[81], unsigned int mask[81]) //return count of deletable cells.
+void *arena_alloc(struct arena *arena, size_t size)
 {
-    int index = 0;
-    for (int i = 0; i < 81; i++) {
-        mask[i] = 0;
-        if (bitset_is_unique(sudoku[i])) {
-            copy_array(sudoku, sud_copy);
-            sud_copy[i] = 0x1ff;
-            if (solve((unsigned int(*)[9]) sud_copy)) {
-                mask[index] = i;
-                index++;
-            }
-        }
+    size_t start = arena->used + (-(uintptr_t) (arena->memory + arena->used) & (ARENA_ALIGN - 1));
+    if (start > arena->size || size > arena->size - start) {
+        return NULL;
     }
-    return index;
+    arena->used = start + size;
+    return arena->memory + start;
 }
 
 /**
- * @brief           Return pseudo-random number from 0 to (limit - 1)  
+ * @brief           Release the blocks allocated after the mark.
  *
- * @param limit     limit of searching random numbers
+ * @param arena     the arena
+ * @param mark      used size of the arena to return to
  * 
- * @return          pseudo-random number from 0 to (limit - 1)
+ * @return          None
  */
-int shake(int limit)
+void arena_release(struct arena *arena, size_t mark)
 {
-    return rand() % limit;
-}
-
-bool is_empty(unsigned int sudoku[81]) {
-    for (int i = 0; i < 81; i++) {
-        if (sudoku[i] != 0x1ff) {
-            return false;
-        } 
+    if (mark < arena->used) {
+        arena->used = mark;
     }
-    return true;
 }
+
 /**
- * @brief           The function removes unique elements if it loses
- *                  its solution after removing any other sudoku cells.  
+ * @brief           Release all blocks of the arena.
  *
- * @param sudoku    sudoku (array 9x9)
+ * @param arena     the arena
  * 
- * @return          None -> function modify array
+ * @return          None
  */
-void generate(unsigned int sudoku[9][9])
+void arena_reset(struct arena *arena)
 {
-    unsigned int *sud = (unsigned int *) sudoku;
-    unsigned int sud_copy[81];
-    unsigned int mask[81] = { 0 };
-    int i;
-    int count = is_solvable(sud, sud_copy, mask);
-
-    while (count > 0) {
-        i = mask[shake(count)];
-        sud[i] = 0x1ff;
-        count = is_solvable(sud, sud_copy, mask);
-    }
+    arena->used = 0;
 }
 
+/* ************************************************************** *
+ *                      Incremental updates                       *
+ * ************************************************************** */
+
 /**
- * @brief Tries to solve the sudoku using backtracking and elimination 
+ * @brief           Remove digit of the known cell from its peers and
+ *                  continue with every peer which becomes known.
  *
- * @param sudoku    sudoku (array 9x9)
+ * @param sudoku    sudoku in 1D format
+ * @param trail     trail logging the removals, may be NULL
+ * @param cell      index of the known cell
  * 
- * @return          solution found -> true
+ * @return          no contradiction has been found -> true
  *                  otherwise -> false
  */
-bool generic_solve(unsigned int sudoku[9][9])
+static bool propagate_cell(unsigned int sudoku[81], struct trail *trail, int cell)
 {
-    if (!is_valid(sudoku)) {
-        return false;
-    }
-    for (int row = 0; row < 9; row++) {
-        for (int col = 0; col < 9; col++) {
-            if (!bitset_is_unique(sudoku[row][col])) {
-                unsigned int orig_sud[9][9];
-                copy_array((unsigned int *) sudoku, (unsigned int *) orig_sud);
-                if (solve(sudoku)) {
-                    return true;
+    int queue[81], head = 0, tail = 0;
+    queue[tail++] = cell;
+    while (head < tail) {
+        int current = queue[head++];
+        int houses[3] = { current / 9, 9 + current % 9, 18 + (current / 27) * 3 + (current % 9) / 3 };
+        for (int h = 0; h < 3; h++) {
+            for (int i = 0; i < 9; i++) {
+                int peer = house_cell(houses[h], i);
+                if (peer == current || (sudoku[peer] & sudoku[current]) == 0) {
+                    continue;
                 }
-                if (bitset_is_unique(sudoku[row][col])) {
-                    return generic_solve(sudoku);
+                if (bitset_is_unique(sudoku[peer])) {
+                    return false;
                 }
-                for (int num = 1; num < 10; num++) {
-                    if (contain(orig_sud[row][col], num)) {
-                        sudoku[row][col] = 0;
-                        sudoku[row][col] = bitset_add(sudoku[row][col], num);
-                        if (generic_solve(sudoku)) {
-                            return true;
-                        }
-                        copy_array((unsigned int *) orig_sud, (unsigned int *) sudoku);
-                    }
+                remove_digits(sudoku, trail, peer, sudoku[current]);
+                if (bitset_is_unique(sudoku[peer])) {
+                    queue[tail++] = peer;
                 }
-                return false;
             }
         }
     }
     return true;
 }
 
-/* ************************************************************** *
- *                      Auxiliary functionns                      *
- * ************************************************************** */
-
 /**
- * @brief            Copy array to another array.
+ * @brief           Place the digit to the cell and remove it from peers.
  *
- * @param copy_from  array which will be copy to array <copy_to> represented as 1D array.
- * @param copy_to    number which should be in bitset.
+ * @param sudoku    sudoku in 2D format
+ * @param cell      index of the cell in 1D format
+ * @param digit     the digit, 1-9
  * 
- * @return           None -> function modify array.
+ * @return          no contradiction has been found -> true
+ *                  otherwise -> false
  */
-void copy_array(unsigned int copy_from[81], unsigned int copy_to[81])
+bool place_digit(unsigned int sudoku[9][9], int cell, int digit)
 {
-    for (int i = 0; i < 81; i++) {
-        copy_to[i] = copy_from[i];
+    unsigned int *sud = (unsigned int *) sudoku;
+    if (!contain(sud[cell], digit)) {
+        return false;
     }
+    sud[cell] = bitset_add(0, digit);
+    return propagate_cell(sud, NULL, cell);
 }
 
 /**
- * @brief Check if cell contains value
+ * @brief           Remove the candidate from the cell, if the cell becomes
+ *                  known its digit is removed from peers.
  *
- * @param original  contents of the 2D sudoku cell.
- * @param number    number which should be in bitset
+ * @param sudoku    sudoku in 2D format
+ * @param cell      index of the cell in 1D format
+ * @param digit     the digit, 1-9
  * 
- * @return          bitset contains number -> true
+ * @return          no contradiction has been found -> true
+ *                  otherwise -> false
+ */
+bool remove_candidate(unsigned int sudoku[9][9], int cell, int digit)
+{
+    unsigned int *sud = (unsigned int *) sudoku;
+    if (!contain(sud[cell], digit)) {
+        return true;
+    }
+    sud[cell] &= ~bitset_add(0, digit);
+    if (sud[cell] == EMPTY_CELL) {
+        return false;
+    }
+    return !bitset_is_unique(sud[cell]) || propagate_cell(sud, NULL, cell);
+}
+
+/* ************************************************************** *
+ *                      Advanced techniques                       *
+ * ************************************************************** */
+
+/**
+ * @brief           Remove digits from unknown cells which see all the
+ *                  given cells.
+ *
+ * @param sudoku     sudoku in 1D format
+ * @param trail      trail logging the removals, may be NULL
+ * @param cells      indexes of the cells which must be seen
+ * @param count      count of the cells
+ * @param digits     bitset of digits to be removed
+ * 
+ * @return          elimination has made changes -> true
+ *                  otherwise -> false
+ */
+static bool eliminate_seen_by(unsigned int sudoku[81], struct trail *trail, const int cells[], int count, unsigned int digits)
+{
+    bool is_change = false;
+    for (int target = 0; target < 81; target++) {
+        if (bitset_is_unique(sudoku[target]) || (sudoku[target] & digits) == 0) {
+            continue;
+        }
+        bool sees_all = true;
+        for (int i = 0; i < count && sees_all; i++) {
+            sees_all = cells_see(target, cells[i]);
+        }
+        if (sees_all) {
+            remove_digits(sudoku, trail, target, digits);
+            is_change = true;
+        }
+    }
+    return is_change;
+}
+
+/**
+ * @brief           function places digits which have the only place
+ *                  left in some house.
+ *
+ * @param sud       sudoku in 1D format
+ * @param trail     trail logging the removals, may be NULL
+ * 
+ * @return          elimination has made changes -> true
+ *                  otherwise -> false
+ */
+static bool hidden_single(unsigned int sud[81], struct trail *trail)
+{
+    bool is_change = false;
+    for (int house = 0; house < 27; house++) {
+        for (int num = 1; num < 10; num++) {
+            int place = -1, count = 0;
+            for (int i = 0; i < 9 && count < 2; i++) {
+                int cell = house_cell(house, i);
+                if (contain(sud[cell], num)) {
+                    place = cell;
+                    count++;
+                }
+            }
+            if (count == 1 && !bitset_is_unique(sud[place])) {
+                remove_digits(sud, trail, place, ~bitset_add(0, num));
+                is_change = true;
+            }
+        }
+    }
+    return is_change;
+}
+
+/**
+ * @brief           Public variant of <hidden_single()> without a trail.
+ *
+ * @param sudoku    sudoku in 2D format
+ * 
+ * @return          elimination has made changes -> true
+ *                  otherwise -> false
+ */
+bool eliminate_hidden_single(unsigned int sudoku[9][9])
+{
+    return hidden_single((unsigned int *) sudoku, NULL);
+}
+
+/**
+ * @brief           function eliminates candidates removed by XY-Wings.
+ *
+ * @param sud       sudoku in 1D format
+ * @param trail     trail logging the removals, may be NULL
+ * 
+ * @return          elimination has made changes -> true
+ *                  otherwise -> false
+ */
+static bool xy_wing(unsigned int sud[81], struct trail *trail)
+{
+    bool is_change = false;
+    for (int pivot = 0; pivot < 81; pivot++) {
+        if (bitset_count(sud[pivot]) != 2) {
+            continue;
+        }
+        for (int first = 0; first < 81; first++) {
+            unsigned int shared = sud[pivot] & sud[first];
+            if (!cells_see(pivot, first) || bitset_count(sud[first]) != 2 || bitset_count(shared) != 1) {
+                continue;
+            }
+            unsigned int z = sud[first] & ~shared;
+            unsigned int wanted = (sud[pivot] & ~shared) | z;
+            for (int second = 0; second < 81; second++) {
+                if (sud[second] == wanted && cells_see(pivot, second)) {
+                    int pincers[2] = { first, second };
+                    is_change = eliminate_seen_by(sud, trail, pincers, 2, z) || is_change;
+                }
+            }
+        }
+    }
+    return is_change;
+}
+
+/**
+ * @brief           Public variant of <xy_wing()> without a trail.
+ *
+ * @param sudoku    sudoku in 2D format
+ * 
+ * @return          elimination has made changes -> true
+ *                  otherwise -> false
+ */
+bool eliminate_xy_wing(unsigned int sudoku[9][9])
+{
+    return xy_wing((unsigned int *) sudoku, NULL);
+}
+
+/**
+ * @brief           function eliminates candidates removed by XYZ-Wings.
+ *
+ * @param sud       sudoku in 1D format
+ * @param trail     trail logging the removals, may be NULL
+ * 
+ * @return          elimination has made changes -> true
+ *                  otherwise -> false
+ */
+static bool xyz_wing(unsigned int sud[81], struct trail *trail)
+{
+    bool is_change = false;
+    for (int pivot = 0; pivot < 81; pivot++) {
+        if (bitset_count(sud[pivot]) != 3) {
+            continue;
+        }
+        for (int first = 0; first < 81; first++) {
+            if (bitset_count(sud[first]) != 2 || (sud[first] & ~sud[pivot]) != 0 || !cells_see(pivot, first)) {
+                continue;
+            }
+            for (int second = first + 1; second < 81; second++) {
+                if (bitset_count(sud[second]) != 2 || (sud[second] & ~sud[pivot]) != 0
+                        || (sud[first] | sud[second]) != sud[pivot] || !cells_see(pivot, second)) {
+                    continue;
+                }
+                int wing[3] = { pivot, first, second };
+                is_change = eliminate_seen_by(sud, trail, wing, 3, sud[first] & sud[second]) || is_change;
+            }
+        }
+    }
+    return is_change;
+}
+
+/**
+ * @brief           Public variant of <xyz_wing()> without a trail.
+ *
+ * @param sudoku    sudoku in 2D format
+ * 
+ * @return          elimination has made changes -> true
+ *                  otherwise -> false
+ */
+bool eliminate_xyz_wing(unsigned int sudoku[9][9])
+{
+    return xyz_wing((unsigned int *) sudoku, NULL);
+}
+
+/**
+ * @brief           Build graph of conjugate pairs of the digit, i.e. pairs
+ *                  of unknown cells which are the only two places for
+ *                  the digit in some house.
+ *
+ * @param sudoku     sudoku in 1D format
+ * @param digit      bitset of the digit
+ * @param links      conjugate partners of each cell (at most one per house)
+ * @param degree     count of conjugate partners of each cell
+ * 
+ * @return          None -> function fills <links> and <degree>
+ */
+static void make_conjugate_graph(unsigned int sudoku[81], unsigned int digit, int links[81][3], int degree[81])
+{
+    for (int i = 0; i < 81; i++) {
+        degree[i] = 0;
+    }
+    for (int house = 0; house < 27; house++) {
+        int places[2], count = 0;
+        for (int i = 0; i < 9; i++) {
+            int cell = house_cell(house, i);
+            if ((sudoku[cell] & digit) != 0) {
+                if (count < 2) {
+                    places[count] = cell;
+                }
+                count++;
+            }
+        }
+        if (count == 2 && !bitset_is_unique(sudoku[places[0]]) && !bitset_is_unique(sudoku[places[1]])) {
+            links[places[0]][degree[places[0]]++] = places[1];
+            links[places[1]][degree[places[1]]++] = places[0];
+        }
+    }
+}
+
+/**
+ * @brief           function eliminates candidates using simple coloring
+ *                  (color wrap and color trap) for each digit.
+ *
+ * @param sud       sudoku in 1D format
+ * @param trail     trail logging the removals, may be NULL
+ * 
+ * @return          elimination has made changes -> true
+ *                  otherwise -> false
+ */
+static bool simple_coloring(unsigned int sud[81], struct trail *trail)
+{
+    bool is_change = false;
+    for (int num = 1; num < 10; num++) {
+        unsigned int digit = bitset_add(0, num);
+        int links[81][3], degree[81], color[81] = { 0 };
+        make_conjugate_graph(sud, digit, links, degree);
+        for (int start = 0, component = 1; start < 81; start++) {
+            if (degree[start] == 0 || color[start] != 0) {
+                continue;
+            }
+            int chain[81], length = 0;
+            color[start] = component;
+            chain[length++] = start;
+            for (int i = 0; i < length; i++) {
+                for (int j = 0; j < degree[chain[i]]; j++) {
+                    int next = links[chain[i]][j];
+                    if (color[next] == 0) {
+                        color[next] = -color[chain[i]];
+                        chain[length++] = next;
+                    }
+                }
+            }
+            int false_color = 0;
+            for (int i = 0; i < length && false_color == 0; i++) {
+                for (int j = i + 1; j < length; j++) {
+                    if (color[chain[i]] == color[chain[j]] && cells_see(chain[i], chain[j])) {
+                        false_color = color[chain[i]];
+                        break;
+                    }
+                }
+            }
+            for (int i = 0; i < length; i++) {
+                if (color[chain[i]] == false_color) {
+                    remove_digits(sud, trail, chain[i], digit);
+                    is_change = true;
+                }
+            }
+            for (int target = 0; target < 81; target++) {
+                if (color[target] == component || color[target] == -component
+                        || bitset_is_unique(sud[target]) || (sud[target] & digit) == 0) {
+                    continue;
+                }
+                bool sees_positive = false, sees_negative = false;
+                for (int i = 0; i < length; i++) {
+                    if (cells_see(target, chain[i])) {
+                        sees_positive = sees_positive || color[chain[i]] == component;
+                        sees_negative = sees_negative || color[chain[i]] == -component;
+                    }
+                }
+                if (sees_positive && sees_negative) {
+                    remove_digits(sud, trail, target, digit);
+                    is_change = true;
+                }
+            }
+            component++;
+        }
+    }
+    return is_change;
+}
+
+/**
+ * @brief           Public variant of <simple_coloring()> without a trail.
+ *
+ * @param sudoku    sudoku in 2D format
+ * 
+ * @return          elimination has made changes -> true
+ *                  otherwise -> false
+ */
+bool eliminate_simple_coloring(unsigned int sudoku[9][9])
+{
+    return simple_coloring((unsigned int *) sudoku, NULL);
+}
+
+/**
+ * @brief           The function tries to solve the sudoku using elimination
+ *                  and, when it gets stuck, the wing and coloring techniques
+ *                  in the order of their cost.
+ *
+ * @param sudoku    sudoku in 2D format 
+ * 
+ * @return          has been successfully solved -> true
+ *                  otherwise -> false
+ */
+bool solve_advanced(unsigned int sudoku[9][9])
+{
+    while (!solve(sudoku)) {
+        if (!is_valid(sudoku)) {
+            return false;
+        }
+        if (!eliminate_hidden_single(sudoku) && !eliminate_xy_wing(sudoku) && !eliminate_xyz_wing(sudoku)
+                && !eliminate_simple_coloring(sudoku)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief           One sweep of the elimination over all rows, cols and boxes.
+ *
+ * @param sudoku    sudoku in 2D format 
+ * 
+ * @return          elimination has made changes -> true
+ *                  otherwise -> false
+ */
+static bool eliminate_all(unsigned int sudoku[9][9])
+{
+    bool is_change = false;
+    for (int i = 0; i < 9; i++) {
+        is_change = eliminate_row(sudoku, i) || is_change;
+        is_change = eliminate_col(sudoku, i) || is_change;
+        is_change = eliminate_box(sudoku, (i / 3) * 3, (i % 3) * 3) || is_change;
+    }
+    return is_change;
+}
+
+/**
+ * @brief           Quiet variant of <solve_advanced()> used by the searches,
+ *                  it runs the eliminations until nothing changes.
+ *
+ * @param sudoku    sudoku in 2D format 
+ * @param trail     trail logging the removals, may be NULL
+ * @param advanced  use also the wing and coloring techniques
+ * 
+ * @return          no contradiction has been found -> true
+ *                  otherwise -> false
+ */
+static bool propagate(unsigned int sudoku[9][9], struct trail *trail, bool advanced)
+{
+    unsigned int *sud = (unsigned int *) sudoku;
+    bool is_change = true;
+    while (is_change) {
+        if (!validate(sudoku, NULL)) {
+            return false;
+        }
+        if (!needs_solving(sudoku)) {
+            return true;
+        }
+        is_change = eliminate_houses(sud, trail) || hidden_single(sud, trail);
+        if (!is_change && advanced) {
+            is_change = xy_wing(sud, trail) || xyz_wing(sud, trail) || simple_coloring(sud, trail);
+        }
+    }
+    return true;
+}
+
+/* ************************************************************** *
+ *                             Rating                             *
+ * ************************************************************** */
+
+/**
+ * @brief           Weight of one use of each technique in the score.
+ */
+static const int TECHNIQUE_WEIGHT[TECHNIQUE_COUNT] = { 1, 2, 20, 25, 30, 100 };
+
+/**
+ * @brief           Apply one step of the technique.
+ *
+ * @param sudoku    sudoku in 2D format 
+ * @param technique the technique
+ * 
+ * @return          technique has made changes -> true
+ *                  otherwise -> false
+ */
+static bool apply_technique(unsigned int sudoku[9][9], enum technique technique)
+{
+    switch (technique) {
+    case TECHNIQUE_ELIMINATION:
+        return eliminate_all(sudoku);
+    case TECHNIQUE_HIDDEN_SINGLE:
+        return eliminate_hidden_single(sudoku);
+    case TECHNIQUE_XY_WING:
+        return eliminate_xy_wing(sudoku);
+    case TECHNIQUE_XYZ_WING:
+        return eliminate_xyz_wing(sudoku);
+    case TECHNIQUE_COLORING:
+        return eliminate_simple_coloring(sudoku);
+    default:
+        return false;
+    }
+}
+
+/**
+ * @brief           Rate the sudoku by the techniques needed to solve it.
+ *                  Every step applies the cheapest technique which makes
+ *                  progress to the current state, so the rating costs
+ *                  about as much as one solve.
+ *
+ * @param sudoku    sudoku in 2D format, solved on success
+ * @param rating    structure for the rating
+ * 
+ * @return          sudoku has a solution -> true
+ *                  otherwise -> false
+ */
+bool rate(unsigned int sudoku[9][9], struct rating *rating)
+{
+    for (int i = 0; i < TECHNIQUE_COUNT; i++) {
+        rating->uses[i] = 0;
+    }
+    rating->hardest = TECHNIQUE_ELIMINATION;
+    rating->score = 0;
+
+    while (is_valid(sudoku) && needs_solving(sudoku)) {
+        enum technique technique = TECHNIQUE_ELIMINATION;
+        while (technique < TECHNIQUE_GUESS && !apply_technique(sudoku, technique)) {
+            technique++;
+        }
+        rating->uses[technique]++;
+        rating->score += TECHNIQUE_WEIGHT[technique];
+        if (technique > rating->hardest) {
+            rating->hardest = technique;
+        }
+        if (technique == TECHNIQUE_GUESS) {
+            return search_solve(sudoku, NULL);
+        }
+    }
+    return is_valid(sudoku);
+}
+
+/**
+ * @brief           Hundredfold of binary logarithm of the count of candidates.
+ */
+static const int CANDIDATE_ENTROPY[10] = { 0, 0, 100, 158, 200, 232, 258, 281, 300, 317 };
+
+/**
+ * @brief           Estimate difficulty of the sudoku from the plain
+ *                  elimination only. The sudoku is not modified.
+ *
+ * @param sudoku    sudoku in 2D format
+ * @param estimate  structure for the counters, may be NULL
+ * 
+ * @return          the estimated score, -1 if the sudoku is invalid
+ */
+int estimate_difficulty(unsigned int sudoku[9][9], struct estimate *estimate)
+{
+    struct estimate result = { 0 };
+    unsigned int sud_copy[9][9];
+    copy_array((unsigned int *) sudoku, (unsigned int *) sud_copy);
+
+    bool is_change = true;
+    while (is_change && is_valid(sud_copy) && needs_solving(sud_copy)) {
+        is_change = eliminate_all(sud_copy);
+        result.sweeps++;
+    }
+    if (!is_valid(sud_copy)) {
+        return -1;
+    }
+    unsigned int *sud = (unsigned int *) sud_copy;
+    for (int i = 0; i < 81; i++) {
+        int count = bitset_count(sud[i]);
+        result.unsolved += count > 1;
+        result.entropy += CANDIDATE_ENTROPY[count];
+    }
+    result.score = result.sweeps + result.unsolved * 10 + result.entropy / 10;
+    if (estimate != NULL) {
+        *estimate = result;
+    }
+    return result.score;
+}
+
+/**
+ * @brief           Read the next block of STDIN if the current one is
+ *                  parsed, the block is shorter when less input is ready.
+ *
+ * @return          some input is buffered -> true
+ *                  otherwise -> false
+ */
+static bool input_fill(void)
+{
+    if (input.pos < input.size) {
+        return true;
+    }
+    input.pos = 0;
+#ifdef INPUT_POSIX
+    ssize_t got;
+    do {
+        got = read(STDIN_FILENO, input.data, INPUT_BLOCK);
+    } while (got < 0 && errno == EINTR);
+    input.size = got > 0 ? (size_t) got : 0;
+#else
+    input.size = fread(input.data, 1, INPUT_BLOCK, stdin);
+#endif
+    return input.size > 0;
+}
+
+/**
+ * @brief           Return the next char of STDIN from the block.
+ *
+ * @return          the char, EOF at the end of input
+ */
+static int input_char(void)
+{
+    return input_fill() ? (unsigned char) input.data[input.pos++] : EOF;
+}
+
+/**
+ * @brief           Parse one line of 81 digits from the block at once.
+ *                  Lines split between blocks or with any other char are
+ *                  left to the char by char parsing.
+ *
+ * @param sudoku    sudoku in 1D format
+ * 
+ * @return          the line has been parsed -> true
+ *                  otherwise -> false
+ */
+static bool input_numeric_line(unsigned int sudoku[81])
+{
+    if (!input_fill() || input.size - input.pos < 82 || input.data[input.pos + 81] != '\n') {
+        return false;
+    }
+    const char *line = input.data + input.pos;
+    for (int i = 0; i < 81; i++) {
+        if (!isdigit((unsigned char) line[i])) {
+            return false;
+        }
+        sudoku[i] = line[i] != '0' ? 1u << (line[i] - '1') : NINE_ONES;
+    }
+    input.pos += 82;
+    return true;
+}
+
+/**
+ * @brief           The function tries to load row of the sudoku in 
+ *                  ASCII format. Function is controlling row with "+-".    
+ *
+ * @param col_index  the index from which the row is to be checked.
+ * 
+ * @return          has been successfully loaded 26 chars -> true
+ *                  otherwise -> false
+ */
+bool check_plus_minus(int col_index)
+{
+    const char pref[] = "+-------+-------+-------+\n";
+    int chr;
+    while (col_index < 26 && (chr = input_char()) != EOF) {
+        if (pref[col_index] != chr) {
+            return false;
+        }
+        col_index++;
+    }
+    return col_index == 26;
+}
+
+/**
+ * @brief           The function tries to load row of the sudoku in 
+ *                  ASCII format. Function is controlling row with numbers.
+ * 
+ * @param row       the index of the row being checked
+ * @param sudoku    sudoku in 2D format 
+ * 
+ * @return          has been successfully loaded 26 chars -> true
+ *                  otherwise -> false
+ */
+bool check_normal_row(int row, unsigned int sudoku[9][9])
+{
+    int cell_pointer = 0, col = 0, chr;
+    while (cell_pointer < 25 && (chr = input_char()) != EOF) {
+        if (cell_pointer % 8 == 0) {
+            if (chr != '|') {
+                return false;
+            }
+        } else if (cell_pointer % 2 == 0) {
+            sudoku[row][col] = 0;
+            if (chr == '.' || chr == '0') {
+                sudoku[row][col] = NINE_ONES;
+            } else if (chr == '!') {
+                sudoku[row][col] = EMPTY_CELL;
+            } else if ('1' <= chr && chr <= '9') {
+                sudoku[row][col] = bitset_add(sudoku[row][col], chr - '0');
+            } else {
+                return false;
+            }
+            col++;
+        } else if (chr != ' ') {
+            return false;
+        }
+        cell_pointer++;
+    }
+    return (cell_pointer == 25) && (input_char() == '\n');
+}
+
+/**
+ * @brief           The function tries to load the sudoku in ASCII format
+ *                  from standard input.   
+ *
+ * @param sudoku    sudoku in 2D format 
+ * 
+ * @return          has been successfully loaded 13 rows -> true
+ *                  otherwise -> false
+ */
+bool load_ascii_format(unsigned int sudoku[9][9])
+{
+    int num_rows_loaded = 0, rows_loaded = 1;
+    while (rows_loaded < 13) {
+        if (rows_loaded % 4 == 0) {
+            if (!check_plus_minus(0)) {
+                return false;
+            }
+        } else {
+            if (!check_normal_row(num_rows_loaded, sudoku)) {
+                return false;
+            }
+            num_rows_loaded++;
+        }
+        rows_loaded++;
+    }
+    return rows_loaded == 13;
+}
+
+/**
+ * @brief           The function tries to load the sudoku in numeric format
+ *                  from standard input.   
+ *
+ * @param sudoku    sudoku in 2D format 
+ * 
+ * @return          has been successfully loaded -> true
+ *                  otherwise -> false
+ */
+bool load_numeric_format(unsigned int sudoku[81])
+{
+    int cell_pointer = 1, chr;
+    while (cell_pointer < 81 && (chr = input_char()) != EOF) {
+        if (!isdigit(chr)) {
+            return false;
+        }
+        sudoku[cell_pointer] = 0;
+        sudoku[cell_pointer] = (chr != '0') ? bitset_add(sudoku[cell_pointer], chr - '0') : NINE_ONES;
+        cell_pointer++;
+    }
+    return cell_pointer == 81 && (((chr = input_char()) == EOF) || chr == '\n');
+}
+
+/**
+ * @brief           The function decides which of the two formats will 
+ *                  be loaded and calls it. Whole numeric lines are
+ *                  parsed directly from the block of STDIN.
+ *
+ * @param sudoku    sudoku in 2D format 
+ * 
+ * @return          has been successfully loaded -> true
+ *                  otherwise -> false
+ */
+bool load(unsigned int sudoku[9][9])
+{
+    if (input_numeric_line((unsigned int *) sudoku)) {
+        return true;
+    }
+    int chr = input_char();
+    if (isdigit(chr)) {
+        int num = chr - '0';
+        sudoku[0][0] = 0;
+        sudoku[0][0] = (num != 0) ? bitset_add(sudoku[0][0], num) : NINE_ONES;
+        if (load_numeric_format((unsigned int *) sudoku)) {
+            return true;
+        }
+    }
+    if (chr == '+') {
+        if (check_plus_minus(1) && load_ascii_format(sudoku)) {
+            return true;
+        }
+    }
+    fprintf(stderr, ERROR);
+    return false;
+}
+
+/**
+ * @brief           The function parses the sudoku in numeric format from
+ *                  one line in memory. Unlike <load()> it accepts also '.'
+ *                  for unknown cells and reports nothing on STDERR.
+ *
+ * @param line      the line without newline
+ * @param length    length of the line
+ * @param sudoku    sudoku in 2D format 
+ * 
+ * @return          has been successfully parsed -> true
+ *                  otherwise -> false
+ */
+bool parse_line(const char *line, size_t length, unsigned int sudoku[9][9])
+{
+    unsigned int *sud = (unsigned int *) sudoku;
+    if (length > 81 && line[81] == '\r') {
+        length--;
+    }
+    if (length != 81) {
+        return false;
+    }
+    for (int i = 0; i < 81; i++) {
+        if (line[i] == '.' || line[i] == '0') {
+            sud[i] = NINE_ONES;
+        } else if ('1' <= line[i] && line[i] <= '9') {
+            sud[i] = bitset_add(0, line[i] - '0');
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief           Parse one bitmask of the candidate format.
+ *
+ * @param line      the line
+ * @param length    length of the line
+ * @param pos       position in the line, moved after the bitmask
+ * @param digits    set to the bitmask
+ * 
+ * @return          bitmask of at most 9 bits follows -> true
+ *                  otherwise -> false
+ */
+static bool parse_bitmask(const char *line, size_t length, size_t *pos, unsigned int *digits)
+{
+    while (*pos < length && (line[*pos] == ' ' || line[*pos] == '\t' || line[*pos] == ',')) {
+        (*pos)++;
+    }
+    size_t start = *pos;
+    *digits = 0;
+    while (*pos < length && isdigit((unsigned char) line[*pos]) && *digits <= NINE_ONES) {
+        *digits = *digits * 10 + (unsigned int) (line[(*pos)++] - '0');
+    }
+    return *pos > start && *digits <= NINE_ONES;
+}
+
+/**
+ * @brief           The function parses the sudoku in candidate format from
+ *                  one line in memory, either 729 chars with the candidate
+ *                  digits of every square at their places, or 81 decimal
+ *                  bitmasks.
+ *
+ * @param line      the line without newline
+ * @param length    length of the line
+ * @param sudoku    sudoku in 2D format 
+ * 
+ * @return          has been successfully parsed -> true
+ *                  otherwise -> false
+ */
+bool parse_candidates(const char *line, size_t length, unsigned int sudoku[9][9])
+{
+    unsigned int *sud = (unsigned int *) sudoku;
+    if (length > 0 && line[length - 1] == '\r') {
+        length--;
+    }
+    if (length == 729) {
+        for (int i = 0; i < 729; i++) {
+            if (i % 9 == 0) {
+                sud[i / 9] = 0;
+            }
+            if (line[i] == '1' + i % 9) {
+                sud[i / 9] = bitset_add(sud[i / 9], i % 9 + 1);
+            } else if (line[i] != '.' && line[i] != '0') {
+                return false;
+            }
+        }
+        return true;
+    }
+    size_t pos = 0;
+    for (int i = 0; i < 81; i++) {
+        if (!parse_bitmask(line, length, &pos, &sud[i])
+            || (i < 80 && pos < length && line[pos] != ' ' && line[pos] != '\t' && line[pos] != ',')) {
+            return false;
+        }
+    }
+    while (pos < length && (line[pos] == ' ' || line[pos] == '\t' || line[pos] == ',')) {
+        pos++;
+    }
+    return pos == length;
+}
+
+/**
+ * @brief           Load the sudoku in candidate format from one line of
+ *                  standard input.
+ *
+ * @param sudoku    sudoku in 2D format 
+ * 
+ * @return          has been successfully loaded -> true
+ *                  otherwise -> false
+ */
+bool load_candidates(unsigned int sudoku[9][9])
+{
+    char line[CANDIDATE_LINE];
+    size_t length = 0;
+    int chr;
+    while ((chr = input_char()) != EOF && chr != '\n') {
+        if (length < sizeof(line)) {
+            line[length] = (char) chr;
+        }
+        length++;
+    }
+    if (length > sizeof(line) || !parse_candidates(line, length, sudoku)) {
+        fprintf(stderr, ERROR);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief           Write the candidates of every square as 9 chars, the
+ *                  digit or '.' when it is not a candidate.
+ *
+ * @param sudoku    sudoku in 2D format 
+ * @param line      729 chars followed by newline, not terminated
+ * 
+ * @return          None
+ */
+void format_candidates(unsigned int sudoku[9][9], char line[730])
+{
+    unsigned int *sud = (unsigned int *) sudoku;
+    for (int i = 0; i < 729; i++) {
+        line[i] = contain(sud[i / 9], i % 9 + 1) ? (char) ('1' + i % 9) : '.';
+    }
+    line[729] = '\n';
+}
+
+/**
+ * @brief           Function print the sudoku to standard output.  
+ *
+ * @param sudoku    sudoku in 2D format 
+ * 
+ * @return          None
+ */
+void print(unsigned int sudoku[9][9])
+{
+    char delim[] = "+-------+-------+-------+\n";
+    for (int i = 0; i < 9; i++) {
+        if (i % 3 == 0) {
+            printf("%s", delim);
+        }
+        for (int j = 0; j < 9; j++) {
+            if (j % 3 == 0) {
+                printf("| ");
+            }
+            if (sudoku[i][j] == 0) {
+                printf("! ");
+            } else if (bitset_is_unique(sudoku[i][j])) {
+                printf("%d ", bitset_next(sudoku[i][j], 0));
+            } else {
+                printf(". ");
+            }
+        }
+        printf("|\n");
+    }
+    printf("%s", delim);
+}
+
+/**
+ * @brief           Return digit of the cell, 0 if it is not unique.
+ *
+ * @param cell      contents of the 2D sudoku cell.
+ * 
+ * @return          digit of the cell or 0
+ */
+static int cell_digit(unsigned int cell)
+{
+    return bitset_is_unique(cell) ? bitset_next(cell, 0) : 0;
+}
+
+/**
+ * @brief           Write the sudoku as one line of the numeric format.
+ *
+ * @param sudoku    sudoku in 2D format 
+ * @param line      81 digits followed by newline, not terminated
+ * 
+ * @return          None
+ */
+void format_line(unsigned int sudoku[9][9], char line[82])
+{
+    unsigned int *sud = (unsigned int *) sudoku;
+    for (int i = 0; i < 81; i++) {
+        line[i] = (char) ('0' + cell_digit(sud[i]));
+    }
+    line[81] = '\n';
+}
+
+/**
+ * @brief           Pack the sudoku into 41 bytes, two digits per byte,
+ *                  the first digit in the high nibble.
+ *
+ * @param sudoku    sudoku in 2D format 
+ * @param packed    array for the packed sudoku
+ * 
+ * @return          None
+ */
+void pack_sudoku(unsigned int sudoku[9][9], unsigned char packed[41])
+{
+    unsigned int *sud = (unsigned int *) sudoku;
+    for (int i = 0; i < 41; i++) {
+        int high = cell_digit(sud[2 * i]);
+        int low = (2 * i + 1 < 81) ? cell_digit(sud[2 * i + 1]) : 0;
+        packed[i] = (unsigned char) ((high << 4) | low);
+    }
+}
+
+/**
+ * @brief           Unpack the sudoku packed by <pack_sudoku()>, zero and
+ *                  invalid nibbles become unknown cells.
+ *
+ * @param packed    the packed sudoku
+ * @param sudoku    sudoku in 2D format 
+ * 
+ * @return          None
+ */
+void unpack_sudoku(const unsigned char packed[41], unsigned int sudoku[9][9])
+{
+    unsigned int *sud = (unsigned int *) sudoku;
+    for (int i = 0; i < 81; i++) {
+        int num = (i % 2 == 0) ? packed[i / 2] >> 4 : packed[i / 2] & 0x0f;
+        sud[i] = (num >= 1 && num <= 9) ? bitset_add(0, num) : NINE_ONES;
+    }
+}
+
+/**
+ * @brief           Write out the buffered solutions.
+ *
+ * @param writer    the solution writer
+ * 
+ * @return          all data has been written -> true
+ *                  otherwise -> false
+ */
+bool flush_solutions(struct solution_writer *writer)
+{
+    size_t written = fwrite(writer->buffer, 1, writer->used, writer->file);
+    bool success = written == writer->used;
+    writer->used = 0;
+    return success;
+}
+
+/**
+ * @brief           Append the solution to the buffer of the writer, it
+ *                  has signature of the <enumerate_solutions()> callback.
+ *
+ * @param solution  sudoku in 2D format 
+ * @param writer    the solution writer
+ * 
+ * @return          buffer has been flushed successfully -> true
+ *                  otherwise -> false
+ */
+bool write_solution(unsigned int solution[9][9], void *writer)
+{
+    struct solution_writer *out = writer;
+    if (out->used + 82 > sizeof(out->buffer) && !flush_solutions(out)) {
+        return false;
+    }
+    if (out->packed) {
+        pack_sudoku(solution, out->buffer + out->used);
+        out->used += 41;
+    } else {
+        format_line(solution, (char *) out->buffer + out->used);
+        out->used += 82;
+    }
+    return true;
+}
+
+/**
+ * @brief           Append the decimal digits of the number.
+ *
+ * @param out       the output
+ * @param value     the number
+ * 
+ * @return          count of the digits
+ */
+static size_t append_number(char *out, unsigned long long value)
+{
+    char digits[20];
+    size_t count = 0;
+    do {
+        digits[count++] = (char) ('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+    for (size_t i = 0; i < count; i++) {
+        out[i] = digits[count - 1 - i];
+    }
+    return count;
+}
+
+/**
+ * @brief           Append the string without its terminator.
+ *
+ * @param out       the output
+ * @param text      the string
+ * 
+ * @return          length of the string
+ */
+static size_t append_text(char *out, const char *text)
+{
+    size_t length = strlen(text);
+    memcpy(out, text, length);
+    return length;
+}
+
+/* the numbers have at most 20 digits and the unsolved results are shorter than the solved ones */
+typedef char result_line_fits[(sizeof(unsigned long long) <= 8 && sizeof(unsigned long) <= 8
+                               && sizeof("unsolvable\",\"solution\":null") <= sizeof("solved\",\"solution\":\"\"") + 81)
+                                  ? 1
+                                  : -1];
+
+/**
+ * @brief           Write the result as one JSON Lines object.
+ *
+ * @param result    metadata of the puzzle
+ * @param solution  sudoku in 2D format, written only if solved
+ * @param line      array for the line
+ * 
+ * @return          length of the line
+ */
+size_t format_result(const struct result *result, unsigned int solution[9][9], char line[RESULT_LINE])
+{
+    static const char *const STATUS[] = { "solved", "unsolvable", "invalid", "failed" };
+    size_t length = append_text(line, "{\"id\":");
+    length += append_number(line + length, result->id);
+    length += append_text(line + length, ",\"status\":\"");
+    length += append_text(line + length, STATUS[result->status]);
+    if (result->status == RESULT_SOLVED) {
+        length += append_text(line + length, "\",\"solution\":\"");
+        format_line(solution, line + length);
+        length += 81;
+        line[length++] = '"';
+    } else {
+        length += append_text(line + length, "\",\"solution\":null");
+    }
+    length += append_text(line + length, ",\"nodes\":");
+    length += append_number(line + length, result->nodes);
+    length += append_text(line + length, ",\"time_us\":");
+    length += append_number(line + length, result->microseconds);
+    length += append_text(line + length, "}\n");
+    return length;
+}
+
+/**
+ * @brief           Append the result to the buffer of the writer.
+ *
+ * @param writer    the solution writer
+ * @param result    metadata of the puzzle
+ * @param solution  sudoku in 2D format, written only if solved
+ * 
+ * @return          buffer has been flushed successfully -> true
+ *                  otherwise -> false
+ */
+bool write_result(struct solution_writer *writer, const struct result *result, unsigned int solution[9][9])
+{
+    if (writer->used + RESULT_LINE > sizeof(writer->buffer) && !flush_solutions(writer)) {
+        return false;
+    }
+    writer->used += format_result(result, solution, (char *) writer->buffer + writer->used);
+    return true;
+}
+
+/* ************************************************************** *
+ *                       Bulk verification                        *
+ * ************************************************************** */
+
+/**
+ * @brief           Check the char of a puzzle record, a digit, '0' or '.'.
+ *
+ * @param chr       the char
+ * 
+ * @return          char is allowed in a puzzle -> true
+ *                  otherwise -> false
+ */
+static bool puzzle_char(char chr)
+{
+    return ('0' <= chr && chr <= '9') || chr == '.';
+}
+
+/**
+ * @brief           Check one solution against its puzzle, both given as
+ *                  81 ASCII digits. Any other char of the puzzle than a
+ *                  digit or '.' fails it, as does any other char of the
+ *                  solution than 1-9, which then misses in its houses.
+ *
+ * @param puzzle    digits of the puzzle, '0' or '.' for unknown
+ * @param solution  digits of the solution
+ * 
+ * @return          solution is complete, valid and keeps the givens -> true
+ *                  otherwise -> false
+ */
+static bool verify_solution(const char *puzzle, const char *solution)
+{
+    unsigned short one_hot[81];
+    for (int i = 0; i < 81; i++) {
+        one_hot[i] = ('1' <= solution[i] && solution[i] <= '9') ? (unsigned short) bitset_add(0, solution[i] - '0') : 0;
+    }
+#ifdef __SSE2__
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i all = _mm_set1_epi16((short) NINE_ONES);
+    const __m128i given_low = _mm_set1_epi8('0'), given_high = _mm_set1_epi8('9' + 1);
+    const __m128i zero_char = _mm_set1_epi8('0'), dot_char = _mm_set1_epi8('.');
+    int mismatch = 0, known = 0xffff;
+    for (int i = 0; i < 80; i += 16) {
+        __m128i p = _mm_loadu_si128((const __m128i *) (puzzle + i));
+        __m128i s = _mm_loadu_si128((const __m128i *) (solution + i));
+        __m128i given = _mm_and_si128(_mm_cmpgt_epi8(p, given_low), _mm_cmplt_epi8(p, given_high));
+        __m128i unknown = _mm_or_si128(_mm_cmpeq_epi8(p, zero_char), _mm_cmpeq_epi8(p, dot_char));
+        mismatch |= _mm_movemask_epi8(_mm_andnot_si128(_mm_cmpeq_epi8(p, s), given));
+        known &= _mm_movemask_epi8(_mm_or_si128(given, unknown));
+    }
+    if (mismatch != 0 || known != 0xffff || !puzzle_char(puzzle[80])
+            || ('1' <= puzzle[80] && puzzle[80] <= '9' && puzzle[80] != solution[80])) {
+        return false;
+    }
+
+    /* every row in 16 lanes, col c in lane c + c / 3, so each box has lanes of its own */
+    __m128i rows[9][2], cols[2] = { zero, zero };
+    for (int r = 0; r < 9; r++) {
+        const unsigned short *row = one_hot + r * 9;
+        rows[r][0] = _mm_setr_epi16((short) row[0], (short) row[1], (short) row[2], 0,
+                                    (short) row[3], (short) row[4], (short) row[5], 0);
+        rows[r][1] = _mm_setr_epi16((short) row[6], (short) row[7], (short) row[8], 0, 0, 0, 0, 0);
+        cols[0] = _mm_or_si128(cols[0], rows[r][0]);
+        cols[1] = _mm_or_si128(cols[1], rows[r][1]);
+
+        __m128i line = _mm_or_si128(rows[r][0], rows[r][1]);
+        line = _mm_or_si128(line, _mm_srli_si128(line, 8));
+        line = _mm_or_si128(line, _mm_or_si128(_mm_srli_si128(line, 2), _mm_srli_si128(line, 4)));
+        if ((_mm_movemask_epi8(_mm_cmpeq_epi16(line, all)) & 0x0003) != 0x0003) {
+            return false;
+        }
+    }
+    if ((_mm_movemask_epi8(_mm_cmpeq_epi16(cols[0], all)) & 0x3f3f) != 0x3f3f
+            || (_mm_movemask_epi8(_mm_cmpeq_epi16(cols[1], all)) & 0x003f) != 0x003f) {
+        return false;
+    }
+    for (int band = 0; band < 9; band += 3) {
+        for (int half = 0; half < 2; half++) {
+            __m128i box = _mm_or_si128(rows[band][half], _mm_or_si128(rows[band + 1][half], rows[band + 2][half]));
+            box = _mm_or_si128(box, _mm_or_si128(_mm_srli_si128(box, 2), _mm_srli_si128(box, 4)));
+            int expected = half == 0 ? 0x0303 : 0x0003;
+            if ((_mm_movemask_epi8(_mm_cmpeq_epi16(box, all)) & expected) != expected) {
+                return false;
+            }
+        }
+    }
+    return true;
+#else
+    for (int i = 0; i < 81; i++) {
+        if (!puzzle_char(puzzle[i]) || ('1' <= puzzle[i] && puzzle[i] <= '9' && puzzle[i] != solution[i])) {
+            return false;
+        }
+    }
+    for (int house = 0; house < 27; house++) {
+        unsigned int mask = 0;
+        for (int i = 0; i < 9; i++) {
+            mask |= one_hot[house_cell(house, i)];
+        }
+        if (mask != NINE_ONES) {
+            return false;
+        }
+    }
+    return true;
+#endif
+}
+
+/**
+ * @brief           Verify many solutions against their puzzles at once.
+ *
+ * @param puzzles   records of the puzzles, 81 ASCII digits each
+ * @param solutions records of the solutions, 81 ASCII digits each
+ * @param stride    distance between starts of the records in bytes
+ * @param count     count of the records
+ * @param passed    bitmap of the results, bit i % 8 of byte i / 8
+ *                  is set when i-th solution passes
+ * 
+ * @return          count of passed solutions
+ */
+size_t verify_solutions(const char *puzzles, const char *solutions, size_t stride, size_t count,
+                        unsigned char *passed)
+{
+    size_t total = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (i % 8 == 0) {
+            passed[i / 8] = 0;
+        }
+        if (verify_solution(puzzles + i * stride, solutions + i * stride)) {
+            passed[i / 8] |= (unsigned char) (1 << (i % 8));
+            total++;
+        }
+    }
+    return total;
+}
+
+/* ************************************************************** *
+ *                            Isomorphs                           *
+ * ************************************************************** */
+
+/**
+ * @brief           Advance the xorshift generator and return its value.
+ *
+ * @param random    state of the generator, must not be 0
+ * 
+ * @return          next random number
+ */
+static unsigned int isomorph_next(unsigned int *random)
+{
+    unsigned int x = *random;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *random = x;
+    return x;
+}
+
+/**
+ * @brief           Fill the items by random permutation of 0 .. count - 1.
+ *
+ * @param items     array of the items
+ * @param count     count of the items
+ * @param random    state of the generator
+ * 
+ * @return          None
+ */
+static void permute_random(unsigned char *items, int count, unsigned int *random)
+{
+    for (int i = 0; i < count; i++) {
+        int j = (int) (isomorph_next(random) % (unsigned int) (i + 1));
+        items[i] = (unsigned char) i;
+        unsigned char item = items[j];
+        items[j] = items[i];
+        items[i] = item;
+    }
+}
+
+/**
+ * @brief           Fill the items by the permutation of 0 .. count - 1
+ *                  given by the lowest factorial digits of the index.
+ *
+ * @param items     array of the items
+ * @param count     count of the items
+ * @param index     index of the isomorph, it is divided by count!
+ * 
+ * @return          None
+ */
+static void permute_nth(unsigned char *items, int count, unsigned long long *index)
+{
+    for (int i = 0; i < count; i++) {
+        items[i] = (unsigned char) i;
+    }
+    for (int i = 0; i < count; i++) {
+        int j = i + (int) (*index % (unsigned long long) (count - i));
+        *index /= (unsigned long long) (count - i);
+        unsigned char item = items[j];
+        for (; j > i; j--) {
+            items[j] = items[j - 1];
+        }
+        items[i] = item;
+    }
+}
+
+/**
+ * @brief           Compose rows (or columns) from permutation of the bands
+ *                  and permutations of the lines within each band.
+ *
+ * @param lines     array of the 9 lines
+ * @param bands     permutation of the bands
+ * @param within    permutations of the lines within the bands
+ * 
+ * @return          None
+ */
+static void compose_lines(unsigned char lines[9], const unsigned char bands[3], unsigned char within[3][3])
+{
+    for (int band = 0; band < 3; band++) {
+        for (int i = 0; i < 3; i++) {
+            lines[band * 3 + i] = (unsigned char) (bands[band] * 3 + within[band][i]);
+        }
+    }
+}
+
+/**
+ * @brief           Make random isomorph from the seed: permutations of the
+ *                  digits, of the bands and stacks, of the lines within
+ *                  them, and the transposition.
+ *
+ * @param isomorph  the isomorph
+ * @param seed      seed of the isomorph, the same seed gives the same one
+ * 
+ * @return          None
+ */
+void isomorph_random(struct isomorph *isomorph, unsigned int seed)
+{
+    unsigned int random = seed * 2654435761u + 1;
+    unsigned char bands[2][3], within[2][3][3];
+    random = random == 0 ? 1 : random;
+
+    permute_random(isomorph->digits, 9, &random);
+    for (int i = 0; i < 2; i++) {
+        permute_random(bands[i], 3, &random);
+        for (int band = 0; band < 3; band++) {
+            permute_random(within[i][band], 3, &random);
+        }
+    }
+    compose_lines(isomorph->rows, bands[0], within[0]);
+    compose_lines(isomorph->cols, bands[1], within[1]);
+    isomorph->transpose = (isomorph_next(&random) & 0x100) != 0;
+}
+
+/**
+ * @brief           Make the index-th isomorph, the index is read as mixed
+ *                  radix number of the permutations, the highest digit is
+ *                  the transposition.
+ *
+ * @param isomorph  the isomorph
+ * @param index     index of the isomorph modulo <ISOMORPH_COUNT>, 0 is
+ *                  the identity
+ * 
+ * @return          None
+ */
+void isomorph_nth(struct isomorph *isomorph, unsigned long long index)
+{
+    unsigned char bands[2][3], within[2][3][3];
+    index %= ISOMORPH_COUNT;
+
+    permute_nth(isomorph->digits, 9, &index);
+    for (int i = 0; i < 2; i++) {
+        permute_nth(bands[i], 3, &index);
+        for (int band = 0; band < 3; band++) {
+            permute_nth(within[i][band], 3, &index);
+        }
+    }
+    compose_lines(isomorph->rows, bands[0], within[0]);
+    compose_lines(isomorph->cols, bands[1], within[1]);
+    isomorph->transpose = index != 0;
+}
+
+/**
+ * @brief           Transform the sudoku by the isomorph.
+ *
+ * @param isomorph  the transformation
+ * @param sudoku    sudoku to be transformed
+ * 
+ * @return          None
+ */
+static void isomorph_board(const struct isomorph *isomorph, unsigned int sudoku[9][9])
+{
+    unsigned int source[9][9];
+    copy_array((unsigned int *) sudoku, (unsigned int *) source);
+
+    for (int row = 0; row < 9; row++) {
+        for (int col = 0; col < 9; col++) {
+            int from_row = isomorph->rows[row], from_col = isomorph->cols[col];
+            unsigned int digits = isomorph->transpose ? source[from_col][from_row] : source[from_row][from_col];
+            unsigned int relabeled = 0;
+            for (int digit = 0; digits != 0; digit++, digits >>= 1) {
+                relabeled |= (digits & 1) << isomorph->digits[digit];
+            }
+            sudoku[row][col] = relabeled;
+        }
+    }
+}
+
+/**
+ * @brief           Transform the puzzle and its solution by the same
+ *                  isomorph, so the solution still solves the puzzle.
+ *
+ * @param isomorph  the transformation
+ * @param sudoku    puzzle to be transformed
+ * @param solution  solution to be transformed, may be NULL
+ * 
+ * @return          None
+ */
+void isomorph_apply(const struct isomorph *isomorph, unsigned int sudoku[9][9], unsigned int solution[9][9])
+{
+    isomorph_board(isomorph, sudoku);
+    if (solution != NULL) {
+        isomorph_board(isomorph, solution);
+    }
+}
+
+/* ************************************************************** *
+ *                         Compact solver                         *
+ * ************************************************************** */
+
+/** flag of a guess which has no alternative digits */
+#define COMPACT_FORCED 0x10
+
+/**
+ * @brief           State of the compact solver, houses are the rows 0-8,
+ *                  columns 9-17 and boxes 18-26.
+ */
+struct compact {
+    unsigned char *packed;
+    unsigned short houses[27];
+    struct {
+        unsigned char cell;
+        unsigned char digit;
+    } guesses[81];
+    int depth;
+};
+
+/**
+ * @brief           Return digit of the packed cell, 0 if it is unknown.
+ *
+ * @param packed    the packed sudoku
+ * @param cell      index of the cell
+ * 
+ * @return          digit of the cell or 0
+ */
+static int compact_get(const unsigned char packed[41], int cell)
+{
+    int num = (cell % 2 == 0) ? packed[cell / 2] >> 4 : packed[cell / 2] & 0x0f;
+    return num <= 9 ? num : 0;
+}
+
+/**
+ * @brief           Set digit of the packed cell and the occupancy of its
+ *                  houses, 0 clears the cell.
+ *
+ * @param state     state of the solver
+ * @param cell      index of the cell
+ * @param num       the digit or 0
+ * 
+ * @return          None
+ */
+static void compact_set(struct compact *state, int cell, int num)
+{
+    int old = compact_get(state->packed, cell);
+    int row = cell / 9, col = cell % 9, box = row / 3 * 3 + col / 3;
+    unsigned short change = (unsigned short) ((old != 0 ? bitset_add(0, old) : 0) ^ (num != 0 ? bitset_add(0, num) : 0));
+    state->houses[row] ^= change;
+    state->houses[9 + col] ^= change;
+    state->houses[18 + box] ^= change;
+    unsigned char *byte = &state->packed[cell / 2];
+    *byte = (cell % 2 == 0) ? (unsigned char) ((*byte & 0x0f) | (num << 4)) : (unsigned char) ((*byte & 0xf0) | num);
+}
+
+/**
+ * @brief           Return candidates of the cell given by its houses.
+ *
+ * @param state     state of the solver
+ * @param cell      index of the cell
+ * 
+ * @return          bitset of the candidates
+ */
+static unsigned int compact_candidates(const struct compact *state, int cell)
+{
+    int row = cell / 9, col = cell % 9, box = row / 3 * 3 + col / 3;
+    return ~(state->houses[row] | state->houses[9 + col] | state->houses[18 + box]) & NINE_ONES;
+}
+
+/**
+ * @brief           Pick the next guess of the compact solver: a digit which
+ *                  has one place left in some house, otherwise the unknown
+ *                  cell with the fewest candidates.
+ *
+ * @param state     state of the solver
+ * @param forced    set to the digit with one place left, 0 for a guess
+ *                  on the cell
+ * 
+ * @return          index of the cell, -1 if all cells are known, -2 if
+ *                  some cell or digit has no place left
+ */
+static int compact_pick(const struct compact *state, int *forced)
+{
+    int best = -1, best_count = 10;
+    *forced = 0;
+    for (int cell = 0; cell < 81 && best_count > 1; cell++) {
+        if (compact_get(state->packed, cell) != 0) {
+            continue;
+        }
+        int count = bitset_count(compact_candidates(state, cell));
+        if (count == 0) {
+            return -2;
+        }
+        if (count < best_count) {
+            best = cell;
+            best_count = count;
+        }
+    }
+    if (best_count <= 1) {
+        return best;
+    }
+    for (int house = 0; house < 27; house++) {
+        unsigned int once = 0, twice = 0;
+        for (int i = 0; i < 9; i++) {
+            int cell = house_cell(house, i);
+            unsigned int candidates = compact_get(state->packed, cell) == 0 ? compact_candidates(state, cell) : 0;
+            twice |= once & candidates;
+            once |= candidates;
+        }
+        unsigned int missing = ~state->houses[house] & NINE_ONES;
+        if ((missing & ~once) != 0) {
+            return -2;
+        }
+        if ((missing & ~twice) == 0) {
+            continue;
+        }
+        *forced = bitset_next(missing & ~twice, 0);
+        for (int i = 0; i < 9; i++) {
+            int cell = house_cell(house, i);
+            if (compact_get(state->packed, cell) == 0 && contain(compact_candidates(state, cell), *forced)) {
+                return cell;
+            }
+        }
+    }
+    *forced = 0;
+    return best;
+}
+
+/**
+ * @brief           Solve the packed sudoku by backtracking. Digits with one
+ *                  place left in a house are placed as guesses without
+ *                  alternatives, otherwise the cell with the fewest
+ *                  candidates is guessed. The guesses are kept on an
+ *                  explicit stack, each record holds the cell and the
+ *                  digit tried there, so nothing is copied per level.
+ *
+ * @param packed    the packed sudoku
+ * @param guesses   set to the count of cells guessed, may be NULL
+ * 
+ * @return          solution found -> true
+ *                  otherwise -> false
+ */
+bool compact_solve(unsigned char packed[41], unsigned long *guesses)
+{
+    struct compact state = { .packed = packed, .depth = 0 };
+    if (guesses != NULL) {
+        *guesses = 0;
+    }
+    for (int cell = 0; cell < 81; cell++) {
+        int num = compact_get(packed, cell);
+        if (num != 0 && !contain(compact_candidates(&state, cell), num)) {
+            return false;
+        }
+        /* the houses start empty, so the nibble is cleared first, invalid ones as well */
+        packed[cell / 2] &= (cell % 2 == 0) ? 0x0f : 0xf0;
+        compact_set(&state, cell, num);
+    }
+    for (;;) {
+        int forced;
+        int cell = compact_pick(&state, &forced);
+        if (cell == -1) {
+            return true;
+        }
+        if (cell >= 0) {
+            state.guesses[state.depth].cell = (unsigned char) cell;
+            state.guesses[state.depth].digit = (unsigned char) (forced != 0 ? forced | COMPACT_FORCED : 0);
+            state.depth++;
+            if (forced != 0) {
+                compact_set(&state, cell, forced);
+                continue;
+            }
+            if (guesses != NULL) {
+                (*guesses)++;
+            }
+        }
+        /* try the next digit of the last guess, popping exhausted ones */
+        while (state.depth > 0) {
+            int guess = state.guesses[state.depth - 1].cell;
+            int num = state.guesses[state.depth - 1].digit;
+            compact_set(&state, guess, 0);
+            num = (num & COMPACT_FORCED) == 0 ? bitset_next(compact_candidates(&state, guess), num) : -1;
+            if (num > 0) {
+                state.guesses[state.depth - 1].digit = (unsigned char) num;
+                compact_set(&state, guess, num);
+                break;
+            }
+            state.depth--;
+        }
+        if (state.depth == 0) {
+            return false;
+        }
+    }
+}
+
+/* ************************************************************** *
+ *                              Bonus                             *
+ * ************************************************************** */
+
+/**
+ * @brief           Return count of cells which can be deleted and
+ *                  sudoku will be still solvable with <solve()>. Indexes
+ *                  of these cells are storing in the <mask>.  
+ *
+ * @param sudoku     original sudoku in 1D format
+ * @param sud_copy   auxiliary array in 1D format
+ * @param mask       auxiliary array in 1D format for storing indexes  
+ * 
+ * @return          count of cells which can be deleted and
+ *                  sudoku will be still solvable with <solve()>.
+ */
+int is_solvable(unsigned int sudoku[81], unsigned int sud_copy[81], unsigned int mask[81]) //return count of deletable cells.
+{
+    int index = 0;
+    for (int i = 0; i < 81; i++) {
+        mask[i] = 0;
+        if (bitset_is_unique(sudoku[i])) {
+            copy_array(sudoku, sud_copy);
+            sud_copy[i] = 0x1ff;
+            if (solve((unsigned int(*)[9]) sud_copy)) {
+                mask[index] = i;
+                index++;
+            }
+        }
+    }
+    return index;
+}
+
+/**
+ * @brief           Return pseudo-random number from 0 to (limit - 1)  
+ *
+ * @param limit     limit of searching random numbers
+ * 
+ * @return          pseudo-random number from 0 to (limit - 1)
+ */
+int shake(int limit)
+{
+    return rand() % limit;
+}
+
+bool is_empty(unsigned int sudoku[81]) {
+    for (int i = 0; i < 81; i++) {
+        if (sudoku[i] != 0x1ff) {
+            return false;
+        } 
+    }
+    return true;
+}
+/**
+ * @brief           The function removes unique elements if it loses
+ *                  its solution after removing any other sudoku cells.  
+ *
+ * @param sudoku    sudoku (array 9x9)
+ * 
+ * @return          None -> function modify array
+ */
+void generate(unsigned int sudoku[9][9])
+{
+    unsigned int *sud = (unsigned int *) sudoku;
+    unsigned int sud_copy[81];
+    unsigned int mask[81] = { 0 };
+    int i;
+    int count = is_solvable(sud, sud_copy, mask);
+
+    while (count > 0) {
+        i = mask[shake(count)];
+        sud[i] = 0x1ff;
+        count = is_solvable(sud, sud_copy, mask);
+    }
+}
+
+/**
+ * @brief           Internal state of one backtracking search.
+ */
+struct search_state {
+    const struct search_options *options;
+    bool (*on_solution)(unsigned int solution[9][9], void *context);
+    void *solution_context;
+    unsigned long solutions;
+    unsigned long max_solutions;
+    unsigned long nodes;
+    unsigned long limit;
+    unsigned int random;
+    unsigned short failures[81][9];
+    struct trail trail;
+    bool randomize;
+    bool stopped;
+    bool interrupted;
+};
+
+/**
+ * @brief           Return next pseudo-random number of the search (xorshift),
+ *                  independent of <rand()> so the search is reproducible
+ *                  and can run on several threads.
+ *
+ * @param state     state of the search
+ * 
+ * @return          pseudo-random number
+ */
+static unsigned int search_random(struct search_state *state)
+{
+    unsigned int x = state->random;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    state->random = x;
+    return x;
+}
+
+/**
+ * @brief           Return index of the unknown cell to branch on.
+ *
+ * @param sudoku    sudoku in 1D format
+ * @param state     state of the search
+ * 
+ * @return          index of the cell, -1 if every cell is known
+ */
+static int search_pick_cell(unsigned int sudoku[81], struct search_state *state)
+{
+    bool fewest = state->options->fewest_candidates || state->randomize;
+    int best = -1, best_count = 10, ties = 0;
+    for (int i = 0; i < 81; i++) {
+        int count = bitset_count(sudoku[i]);
+        if (count <= 1 || count > best_count) {
+            continue;
+        }
+        if (count < best_count) {
+            best = i;
+            best_count = count;
+            ties = 1;
+            if (!fewest || (count == 2 && !state->randomize)) {
+                break;
+            }
+        } else if (state->randomize && search_random(state) % ++ties == 0) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief           Return the score of the digit for the value ordering,
+ *                  digits with lower score are tried first. Randomized
+ *                  search scores the ascending and descending orders
+ *                  alike, so they become random.
+ *
+ * @param sudoku    sudoku in 1D format
+ * @param cell      index of the branching cell
+ * @param num       the digit
+ * @param state     state of the search
+ * 
+ * @return          score of the digit
+ */
+static int search_digit_score(unsigned int sudoku[81], int cell, int num, struct search_state *state)
+{
+    unsigned int digit = bitset_add(0, num);
+    int score = 0;
+    switch (state->options->value_order) {
+    case SEARCH_VALUE_DESCENDING:
+        return state->randomize ? 0 : 10 - num;
+    case SEARCH_VALUE_LEAST_CONSTRAINING:
+        for (int i = 0; i < 81; i++) {
+            if ((sudoku[i] & digit) != 0 && !bitset_is_unique(sudoku[i]) && cells_see(cell, i)) {
+                score++;
+            }
+        }
+        return score;
+    case SEARCH_VALUE_PEER_FREQUENCY:
+        score = 9;
+        for (int house = 0; house < 27; house++) {
+            int places = 0;
+            bool contains_cell = false;
+            for (int i = 0; i < 9; i++) {
+                int other = house_cell(house, i);
+                contains_cell = contains_cell || other == cell;
+                places += (sudoku[other] & digit) != 0;
+            }
+            if (contains_cell && places < score) {
+                score = places;
+            }
+        }
+        return score;
+    case SEARCH_VALUE_LEARNED:
+        return (int) state->failures[cell][num - 1];
+    default:
+        return state->randomize ? 0 : num;
+    }
+}
+
+/**
+ * @brief           Fill digits of the cell in the order they are tried.
+ *                  Randomized search breaks ties of the scores randomly.
+ *
+ * @param sudoku    sudoku in 1D format
+ * @param cell      index of the branching cell
+ * @param digits    array for the digits
+ * @param state     state of the search
+ * 
+ * @return          count of the digits
+ */
+static int search_order_digits(unsigned int sudoku[81], int cell, int digits[9], struct search_state *state)
+{
+    int count = 0;
+    unsigned int keys[9];
+    for (int num = 1; num < 10; num++) {
+        if (!contain(sudoku[cell], num)) {
+            continue;
+        }
+        unsigned int key = (unsigned int) search_digit_score(sudoku, cell, num, state) * 16;
+        key += state->randomize ? search_random(state) % 16 : 0;
+        int i = count++;
+        for (; i > 0 && keys[i - 1] > key; i--) {
+            keys[i] = keys[i - 1];
+            digits[i] = digits[i - 1];
+        }
+        keys[i] = key;
+        digits[i] = num;
+    }
+    return count;
+}
+
+/**
+ * @brief           Recursive part of the backtracking search.
+ *
+ * @param sudoku    sudoku (array 9x9)
+ * @param state     state of the search
+ * 
+ * @return          solution found -> true
+ *                  otherwise -> false
+ */
+static bool search(unsigned int sudoku[9][9], struct search_state *state)
+{
+    const struct search_options *options = state->options;
+    if (!propagate(sudoku, &state->trail, state->max_solutions == 0)) {
+        return false;
+    }
+    int cell = search_pick_cell((unsigned int *) sudoku, state);
+    if (cell < 0 && state->max_solutions == 0) {
+        return true;
+    }
+    if (cell < 0) {
+        state->solutions++;
+        if (state->on_solution != NULL && !state->on_solution(sudoku, state->solution_context)) {
+            state->stopped = true;
+        }
+        state->stopped = state->stopped || state->solutions == state->max_solutions;
+        return false;
+    }
+    state->nodes++;
+    if (options->stop != NULL && state->nodes % 64 == 0 && options->stop(options->context)) {
+        state->stopped = true;
+    }
+    if (options->budget != 0 && state->nodes > options->budget) {
+        state->stopped = true;
+    }
+    if (state->limit != 0 && state->nodes > state->limit) {
+        state->interrupted = true;
+    }
+    if (state->stopped || state->interrupted) {
+        return false;
+    }
+    int digits[9];
+    int count = search_order_digits((unsigned int *) sudoku, cell, digits, state);
+    int mark = state->trail.size;
+    for (int i = 0; i < count; i++) {
+        trail_remove(&state->trail, cell, ~bitset_add(0, digits[i]));
+        if (propagate_cell((unsigned int *) sudoku, &state->trail, cell) && search(sudoku, state)) {
+            return true;
+        }
+        if (state->stopped || state->interrupted) {
+            return false;
+        }
+        if (state->failures[cell][digits[i] - 1] < 0xffff) {
+            state->failures[cell][digits[i] - 1]++;
+        }
+        trail_undo(&state->trail, mark);
+    }
+    return false;
+}
+
+/**
+ * @brief           Return i-th member (from 1) of the Luby sequence
+ *                  1, 1, 2, 1, 1, 2, 4, 1, 1, 2, ...
+ *
+ * @param index     index of the member
+ * 
+ * @return          the member of the sequence
+ */
+static unsigned long luby(unsigned long index)
+{
+    int k = 1;
+    while ((1UL << k) - 1 < index) {
+        k++;
+    }
+    if (index == (1UL << k) - 1) {
+        return 1UL << (k - 1);
+    }
+    return luby(index - (1UL << (k - 1)) + 1);
+}
+
+/**
+ * @brief           Return count of guesses allowed in the run of the search.
+ *
+ * @param options   options of the search
+ * @param run       index of the run, starting from 1
+ * @param previous  count of guesses allowed in the previous run
+ * 
+ * @return          count of guesses, 0 for unlimited
+ */
+static unsigned long restart_limit(const struct search_options *options, unsigned long run, unsigned long previous)
+{
+    unsigned long base = options->restart_nodes != 0 ? options->restart_nodes : 100;
+    switch (options->restart) {
+    case SEARCH_RESTART_LUBY:
+        return base * luby(run);
+    case SEARCH_RESTART_GEOMETRIC:
+        return run == 1 ? base : previous + previous / 2 + 1;
+    default:
+        return 0;
+    }
+}
+
+/**
+ * @brief           Run the search in the given state until some run
+ *                  finishes within its limit. With restarts, every run
+ *                  starts again from the given sudoku with a new random
+ *                  order of branching.
+ *
+ * @param sudoku    sudoku (array 9x9)
+ * @param state     zero initialized state of the search
+ * @param options   options of the search
+ * 
+ * @return          solution found -> true
+ *                  otherwise -> false
+ */
+static bool search_run(unsigned int sudoku[9][9], struct search_state *state, const struct search_options *options)
+{
+    state->options = options;
+    state->randomize = options->restart != SEARCH_RESTART_NONE;
+    state->random = options->seed ^ 0x9e3779b9;
+    if (state->random == 0) {
+        state->random = 1;
+    }
+    if (options->nodes != NULL) {
+        *options->nodes = 0;
+    }
+    if (!is_valid(sudoku)) {
+        return false;
+    }
+    trail_init(&state->trail, sudoku);
+
+    unsigned long allowed = 0;
+    bool solved = false;
+    for (unsigned long run = 1;; run++) {
+        if (state->randomize) {
+            allowed = restart_limit(options, run, allowed);
+            state->limit = state->nodes + allowed;
+        }
+        state->interrupted = false;
+        solved = search(sudoku, state);
+        if (solved) {
+            break;
+        }
+        trail_undo(&state->trail, 0);
+        if (!state->interrupted) {
+            break;
+        }
+    }
+    if (options->nodes != NULL) {
+        *options->nodes = state->nodes;
+    }
+    return solved;
+}
+
+/**
+ * @brief           Run the search with its state on the C stack.
+ *
+ * @param sudoku    sudoku (array 9x9)
+ * @param options   options of the search
+ * 
+ * @return          solution found -> true
+ *                  otherwise -> false
+ */
+static bool search_on_stack(unsigned int sudoku[9][9], const struct search_options *options)
+{
+    struct search_state state = { 0 };
+    return search_run(sudoku, &state, options);
+}
+
+#ifdef SUDOKU_COMPACT
+/**
+ * @brief           Check that the sudoku carries no eliminations beyond
+ *                  its known digits, so the packed sudoku can hold it.
+ *
+ * @param sudoku    sudoku (array 9x9)
+ * 
+ * @return          every cell is known or has all candidates -> true
+ *                  otherwise -> false
+ */
+static bool only_known_digits(unsigned int sudoku[9][9])
+{
+    unsigned int *sud = (unsigned int *) sudoku;
+    for (int i = 0; i < 81; i++) {
+        if (sud[i] != NINE_ONES && !bitset_is_unique(sud[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief           Solve the sudoku packed by <compact_solve()>.
+ *
+ * @param sudoku    sudoku (array 9x9), unchanged if there is no solution
+ * @param options   options of the search, only <nodes> is used
+ * 
+ * @return          solution found -> true
+ *                  otherwise -> false
+ */
+static bool search_compact(unsigned int sudoku[9][9], const struct search_options *options)
+{
+    unsigned char packed[41];
+    pack_sudoku(sudoku, packed);
+    if (!compact_solve(packed, options->nodes)) {
+        return false;
+    }
+    unpack_sudoku(packed, sudoku);
+    return true;
+}
+
+#endif
+/**
+ * @brief           Tries to solve the sudoku using backtracking driven
+ *                  by the given options. The state of the search is taken
+ *                  from the arena of the options and released at the end.
+ *
+ * @param sudoku    sudoku (array 9x9)
+ * @param options   options of the search, NULL for the defaults
+ * 
+ * @return          solution found -> true
+ *                  otherwise -> false
+ */
+bool search_solve(unsigned int sudoku[9][9], const struct search_options *options)
+{
+    const struct search_options defaults = { 0 };
+    options = options != NULL ? options : &defaults;
+#ifdef SUDOKU_COMPACT
+    if (options->stop == NULL && options->budget == 0 && options->restart == SEARCH_RESTART_NONE
+        && only_known_digits(sudoku)) {
+        return search_compact(sudoku, options);
+    }
+#endif
+    struct arena *arena = options->arena;
+    size_t mark = arena != NULL ? arena->used : 0;
+    struct search_state *state = arena != NULL ? arena_alloc(arena, sizeof(struct search_state)) : NULL;
+    if (state == NULL) {
+        return search_on_stack(sudoku, options);
+    }
+    memset(state, 0, sizeof(struct search_state));
+    bool solved = search_run(sudoku, state, options);
+    arena_release(arena, mark);
+    return solved;
+}
+
+/**
+ * @brief Tries to solve the sudoku using backtracking and elimination 
+ *
+ * @param sudoku    sudoku (array 9x9)
+ * 
+ * @return          solution found -> true
+ *                  otherwise -> false
+ */
+bool generic_solve(unsigned int sudoku[9][9])
+{
+    return search_solve(sudoku, NULL);
+}
+
+/**
+ * @brief           Enumerate solutions of the sudoku one by one. All of them
+ *                  are found by a single search, which reports each
+ *                  solution and continues with the next branch. Only
+ *                  plain elimination is used between the guesses, wings
+ *                  and coloring do not pay off with many solutions.
+ *
+ * @param sudoku    sudoku (array 9x9), it is not modified
+ * @param limit     maximal count of solutions, 0 for all of them
+ * @param callback  called for each solution, returning false stops
+ *                  the enumeration (may be NULL to just count)
+ * @param context   passed to <callback>
+ * 
+ * @return          count of solutions found
+ */
+unsigned long enumerate_solutions(unsigned int sudoku[9][9], unsigned long limit,
+                                  bool (*callback)(unsigned int solution[9][9], void *context), void *context)
+{
+    const struct search_options options = { .fewest_candidates = true };
+    struct search_state state = { 0 };
+    unsigned int sud_copy[9][9];
+    state.options = &options;
+    state.on_solution = callback;
+    state.solution_context = context;
+    state.max_solutions = limit != 0 ? limit : (unsigned long) -1;
+    copy_array((unsigned int *) sudoku, (unsigned int *) sud_copy);
+    trail_init(&state.trail, sud_copy);
+    if (is_valid(sud_copy)) {
+        search(sud_copy, &state);
+    }
+    return state.solutions;
+}
+
+/**
+ * @brief           Find cells which have the same value in every solution.
+ *                  For each candidate cell the search asks for a solution
+ *                  with a different value there, every solution found this
+ *                  way rules out all the cells where it differs.
+ *
+ * @param sudoku    sudoku (array 9x9), replaced by union of values
+ *                  of the solutions seen
+ * 
+ * @return          count of backbone cells, -1 if there is no solution
+ */
+int backbone(unsigned int sudoku[9][9])
+{
+    const struct search_options options = { .fewest_candidates = true };
+    unsigned int *sud = (unsigned int *) sudoku;
+    unsigned int fixed[81], solution[81], other[81];
+    bool candidate[81];
+
+    copy_array(sud, fixed);
+    copy_array(sud, solution);
+    if (!search_solve((unsigned int(*)[9]) solution, &options)) {
+        return -1;
+    }
+    for (int i = 0; i < 81; i++) {
+        candidate[i] = !bitset_is_unique(sud[i]);
+        sud[i] = solution[i];
+    }
+    for (int cell = 0; cell < 81; cell++) {
+        if (!candidate[cell]) {
+            continue;
+        }
+        copy_array(fixed, other);
+        other[cell] &= ~solution[cell];
+        if (!search_solve((unsigned int(*)[9]) other, &options)) {
+            fixed[cell] = solution[cell];
+            continue;
+        }
+        for (int i = cell; i < 81; i++) {
+            if (other[i] != solution[i]) {
+                candidate[i] = false;
+            }
+        }
+        for (int i = 0; i < 81; i++) {
+            sud[i] |= other[i];
+        }
+    }
+    int count = 0;
+    for (int i = 0; i < 81; i++) {
+        count += bitset_is_unique(sud[i]);
+    }
+    return count;
+}
+
+/* ************************************************************** *
+ *                      Auxiliary functionns                      *
+ * ************************************************************** */
+
+/**
+ * @brief            Copy array to another array.
+ *
+ * @param copy_from  array which will be copy to array <copy_to> represented as 1D array.
+ * @param copy_to    number which should be in bitset.
+ * 
+ * @return           None -> function modify array.
+ */
+void copy_array(unsigned int copy_from[81], unsigned int copy_to[81])
+{
+    for (int i = 0; i < 81; i++) {
+        copy_to[i] = copy_from[i];
+    }
+}
+
+/**
+ * @brief Check if cell contains value
+ *
+ * @param original  contents of the 2D sudoku cell.
+ * @param number    number which should be in bitset
+ * 
+ * @return          bitset contains number -> true
  *                  otherwise -> false
  */
 bool contain(unsigned int original, int number)
@@ -629,6 +2843,87 @@ static int bitset_next(unsigned int bitset, int previous)
     return -1;
 }
 
+/**
+ * @brief Return count of numbers present in bit set.
+ *
+ * @param bitset    contents of the 2D sudoku cell.
+ * 
+ * @return          count of set bits
+ */
+static int bitset_count(unsigned int bitset)
+{
+    int count = 0;
+    while (bitset != 0) {
+        bitset &= bitset - 1;
+        count++;
+    }
+    return count;
+}
+
+/**
+ * @brief Check whether two different cells share a row, col or box.
+ *
+ * @param first     index of the first cell in 1D format
+ * @param second    index of the second cell in 1D format
+ * 
+ * @return          cells see each other -> true
+ *                  otherwise -> false
+ */
+static bool cells_see(int first, int second)
+{
+    int row_a = first / 9, col_a = first % 9, row_b = second / 9, col_b = second % 9;
+    if (first == second) {
+        return false;
+    }
+    return row_a == row_b || col_a == col_b || (row_a / 3 == row_b / 3 && col_a / 3 == col_b / 3);
+}
+
+/**
+ * @brief           Indexes of cells of each house, rows, cols and boxes.
+ */
+static const unsigned char HOUSE_CELLS[27][9] = {
+    {  0,  1,  2,  3,  4,  5,  6,  7,  8 },
+    {  9, 10, 11, 12, 13, 14, 15, 16, 17 },
+    { 18, 19, 20, 21, 22, 23, 24, 25, 26 },
+    { 27, 28, 29, 30, 31, 32, 33, 34, 35 },
+    { 36, 37, 38, 39, 40, 41, 42, 43, 44 },
+    { 45, 46, 47, 48, 49, 50, 51, 52, 53 },
+    { 54, 55, 56, 57, 58, 59, 60, 61, 62 },
+    { 63, 64, 65, 66, 67, 68, 69, 70, 71 },
+    { 72, 73, 74, 75, 76, 77, 78, 79, 80 },
+    {  0,  9, 18, 27, 36, 45, 54, 63, 72 },
+    {  1, 10, 19, 28, 37, 46, 55, 64, 73 },
+    {  2, 11, 20, 29, 38, 47, 56, 65, 74 },
+    {  3, 12, 21, 30, 39, 48, 57, 66, 75 },
+    {  4, 13, 22, 31, 40, 49, 58, 67, 76 },
+    {  5, 14, 23, 32, 41, 50, 59, 68, 77 },
+    {  6, 15, 24, 33, 42, 51, 60, 69, 78 },
+    {  7, 16, 25, 34, 43, 52, 61, 70, 79 },
+    {  8, 17, 26, 35, 44, 53, 62, 71, 80 },
+    {  0,  1,  2,  9, 10, 11, 18, 19, 20 },
+    {  3,  4,  5, 12, 13, 14, 21, 22, 23 },
+    {  6,  7,  8, 15, 16, 17, 24, 25, 26 },
+    { 27, 28, 29, 36, 37, 38, 45, 46, 47 },
+    { 30, 31, 32, 39, 40, 41, 48, 49, 50 },
+    { 33, 34, 35, 42, 43, 44, 51, 52, 53 },
+    { 54, 55, 56, 63, 64, 65, 72, 73, 74 },
+    { 57, 58, 59, 66, 67, 68, 75, 76, 77 },
+    { 60, 61, 62, 69, 70, 71, 78, 79, 80 },
+};
+
+/**
+ * @brief Return index of the cell in the house.
+ *
+ * @param house     0-8 rows, 9-17 cols, 18-26 boxes
+ * @param index     position of the cell in the house (0-8)
+ * 
+ * @return          index of the cell in 1D format
+ */
+static int house_cell(int house, int index)
+{
+    return HOUSE_CELLS[house][index];
+}
+
 /**
  * @brief Return bitset of values which can be stored in cells in specified area.
  * 
@@ -74,6 +74,32 @@ bool needs_solving(unsigned int sudoku[9][9]);
  */
 bool is_valid(unsigned int sudoku[9][9]);
 
+/**
+ * @brief Problems of the sudoku found by validate().
+ *
+ * Squares are indexed 0 to 80, square i is bit i % 64 of word i / 64.
+ * Houses are indexed 0-8 for rows, 9-17 for cols and 18-26 for boxes.
+ */
+struct validation {
+    /** set squares sharing their digit with a set square in some house */
+    unsigned long long conflicts[2];
+    /** squares where no digit can be placed */
+    unsigned long long empty[2];
+    /** bitset of digits which can not be placed anywhere in the house */
+    unsigned int missing[27];
+};
+
+/**
+ * @brief Check the sudoku like is_valid(), and also for digits which have
+ * no place left in some house, reporting all problems found in one pass.
+ *
+ * @param sudoku 2D array of digit bitsets
+ * @param report of the problems, NULL to stop at the first problem
+ *
+ * @return true if no problem was found.
+ */
+bool validate(unsigned int sudoku[9][9], struct validation *report);
+
 /**
  * @brief Solve the sudoku using elimination as much as possible
  * without guessing or backtracking.
@@ -88,6 +114,283 @@ bool is_valid(unsigned int sudoku[9][9]);
  */
 bool solve(unsigned int sudoku[9][9]);
 
+/* ************************************************************** *
+ *                              Trail                             *
+ * ************************************************************** */
+
+/**
+ * @brief Maximal count of removals on the trail. Every removal takes
+ * at least one candidate away, so 9 per square are enough.
+ */
+#define TRAIL_CAPACITY 729
+
+/**
+ * @brief One logged change: the square and its bitset before the change.
+ */
+struct trail_entry {
+    unsigned char cell;
+    unsigned short mask;
+};
+
+/**
+ * @brief Log of candidate removals, restoring the sudoku by popping the
+ * log instead of copying whole sudokus when backtracking.
+ *
+ * Squares are indexed 0 to 80 from left to right and from top to bottom.
+ * The sudoku may only lose candidates between trail_init() and
+ * trail_undo(), and all its changes must go through trail_remove().
+ */
+struct trail {
+    /** the tracked sudoku as 1D array */
+    unsigned int *sudoku;
+    /** count of used entries, i.e. mark of the current state */
+    int size;
+    struct trail_entry entries[TRAIL_CAPACITY];
+};
+
+/**
+ * @brief Start logging changes of the sudoku.
+ *
+ * @param trail to be initialized
+ * @param sudoku 2D array of digit bitsets
+ */
+void trail_init(struct trail *trail, unsigned int sudoku[9][9]);
+
+/**
+ * @brief Remove digits from the square, logging its previous value.
+ *
+ * @param trail of the sudoku
+ * @param cell index of the square
+ * @param digits bitset of digits to remove
+ *
+ * @return true if the square has changed.
+ */
+bool trail_remove(struct trail *trail, int cell, unsigned int digits);
+
+/**
+ * @brief Undo the changes logged after the mark.
+ *
+ * @param trail of the sudoku
+ * @param mark value of trail->size to return to
+ */
+void trail_undo(struct trail *trail, int mark);
+
+/* ************************************************************** *
+ *                              Arena                             *
+ * ************************************************************** */
+
+/**
+ * @brief Alignment of the blocks given by arena_alloc().
+ */
+#define ARENA_ALIGN 64
+
+/**
+ * @brief Bump allocator for the states of searches and their results,
+ * one per worker or thread, so solving needs no malloc() at all.
+ *
+ * Blocks are released in the reverse order, by returning to a mark,
+ * or all at once by arena_reset() between puzzles.
+ */
+struct arena {
+    /** memory of the arena */
+    unsigned char *memory;
+    /** size of the memory */
+    size_t size;
+    /** count of used bytes, i.e. mark of the current state */
+    size_t used;
+};
+
+/**
+ * @brief Set up the arena in the given memory.
+ *
+ * @param arena to be initialized
+ * @param memory of the arena, owned by the caller
+ * @param size of the memory
+ */
+void arena_init(struct arena *arena, void *memory, size_t size);
+
+/**
+ * @brief Allocate the block of ARENA_ALIGN aligned memory.
+ *
+ * @param arena initialized by arena_init()
+ * @param size of the block
+ *
+ * @return the block, NULL if the arena is full.
+ */
+void *arena_alloc(struct arena *arena, size_t size);
+
+/**
+ * @brief Release the blocks allocated after the mark.
+ *
+ * @param arena initialized by arena_init()
+ * @param mark value of arena->used before the allocations
+ */
+void arena_release(struct arena *arena, size_t mark);
+
+/**
+ * @brief Release all blocks of the arena.
+ *
+ * @param arena initialized by arena_init()
+ */
+void arena_reset(struct arena *arena);
+
+/* ************************************************************** *
+ *                      Incremental updates                       *
+ * ************************************************************** */
+
+/**
+ * @brief Place the digit to the square and remove it from all peers,
+ * following every peer which is left with a single digit.
+ *
+ * @note Cheaper than solve() after each edit, but only the peers of
+ * changed squares are updated.
+ *
+ * @param sudoku 2D array of digit bitsets
+ * @param cell index of the square, 0 to 80
+ * @param digit to be placed, 1 to 9
+ *
+ * @return false on contradiction (the digit is not a candidate of the
+ * square, or some peer has lost all digits), the sudoku is then in
+ * undefined state.
+ */
+bool place_digit(unsigned int sudoku[9][9], int cell, int digit);
+
+/**
+ * @brief Remove the digit from candidates of the square. When one digit
+ * is left, it is propagated as by place_digit().
+ *
+ * @param sudoku 2D array of digit bitsets
+ * @param cell index of the square, 0 to 80
+ * @param digit to be removed, 1 to 9
+ *
+ * @return false on contradiction, the sudoku is then in undefined state.
+ */
+bool remove_candidate(unsigned int sudoku[9][9], int cell, int digit);
+
+/* ************************************************************** *
+ *                      Advanced techniques                       *
+ * ************************************************************** */
+
+/**
+ * @brief Place digits which have only one possible square in a house.
+ *
+ * @param sudoku 2D array of digit bitsets
+ */
+bool eliminate_hidden_single(unsigned int sudoku[9][9]);
+
+/**
+ * @brief Eliminate candidates using the XY-Wing pattern.
+ *
+ * Pivot {x,y} sees two pincers {x,z} and {y,z}; digit z is removed
+ * from every unknown square seeing both pincers.
+ *
+ * @param sudoku 2D array of digit bitsets
+ */
+bool eliminate_xy_wing(unsigned int sudoku[9][9]);
+
+/**
+ * @brief Eliminate candidates using the XYZ-Wing pattern.
+ *
+ * Pivot {x,y,z} sees two pincers {x,z} and {y,z}; digit z is removed
+ * from every unknown square seeing the pivot and both pincers.
+ *
+ * @param sudoku 2D array of digit bitsets
+ */
+bool eliminate_xyz_wing(unsigned int sudoku[9][9]);
+
+/**
+ * @brief Eliminate candidates using simple coloring of conjugate pairs.
+ *
+ * For every digit, squares linked by houses where the digit has exactly
+ * two positions are colored alternately. A color appearing twice in one
+ * house is false, and squares seeing both colors lose the digit.
+ *
+ * @param sudoku 2D array of digit bitsets
+ */
+bool eliminate_simple_coloring(unsigned int sudoku[9][9]);
+
+/**
+ * @brief Solve the sudoku like solve(), additionally applying wing and
+ * coloring techniques whenever plain elimination gets stuck.
+ *
+ * @note Invalid sudoku is reported the same way as in solve().
+ *
+ * @param sudoku 2D array of digit bitsets
+ */
+bool solve_advanced(unsigned int sudoku[9][9]);
+
+/* ************************************************************** *
+ *                             Rating                             *
+ * ************************************************************** */
+
+/**
+ * @brief Techniques of the logical engine ordered by their cost.
+ */
+enum technique {
+    TECHNIQUE_ELIMINATION = 0,
+    TECHNIQUE_HIDDEN_SINGLE,
+    TECHNIQUE_XY_WING,
+    TECHNIQUE_XYZ_WING,
+    TECHNIQUE_COLORING,
+    /** the logic got stuck, backtracking was needed */
+    TECHNIQUE_GUESS,
+    TECHNIQUE_COUNT
+};
+
+/**
+ * @brief Difficulty of a sudoku.
+ */
+struct rating {
+    /** the hardest technique needed */
+    enum technique hardest;
+    /** how many times each technique made progress */
+    unsigned int uses[TECHNIQUE_COUNT];
+    /** weighted sum of the uses, higher is harder */
+    int score;
+};
+
+/**
+ * @brief Rate the sudoku by the hardest technique needed and how often
+ * the techniques were used.
+ *
+ * The techniques are tried in the order of their cost, after every
+ * change the rating starts again from the cheapest one.
+ *
+ * @param sudoku 2D array of digit bitsets, solved on success
+ * @param rating to be filled
+ *
+ * @return false if the sudoku has no solution.
+ */
+bool rate(unsigned int sudoku[9][9], struct rating *rating);
+
+/**
+ * @brief Counters of the quick difficulty estimate.
+ */
+struct estimate {
+    /** sweeps of the elimination until nothing changed */
+    int sweeps;
+    /** squares left with more than one digit */
+    int unsolved;
+    /** sum of log2 of candidate counts, in hundredths of a bit */
+    int entropy;
+    /** sweeps + 10 * unsolved + entropy / 10, at most about 3400 */
+    int score;
+};
+
+/**
+ * @brief Cheap difficulty estimate for routing, much faster than rate().
+ *
+ * Runs only the elimination of solve() to its fixpoint on a copy of the
+ * sudoku and scores what is left. Sudoku solved by elimination scores
+ * only the count of its sweeps.
+ *
+ * @param sudoku 2D array of digit bitsets, it is left unchanged
+ * @param estimate counters to be filled, may be NULL
+ *
+ * @return the score, -1 if the sudoku is invalid.
+ */
+int estimate_difficulty(unsigned int sudoku[9][9], struct estimate *estimate);
+
 /* ************************************************************** *
  *                          Input/Output                          *
  * ************************************************************** */
@@ -108,12 +411,72 @@ bool solve(unsigned int sudoku[9][9]);
  *
  * @note The exact format is described in assignment.
  *
+ * @note STDIN is read in blocks of up to 1 MiB by read(), so it must not
+ * be read by stdio functions between the calls.
+ *
  * @param sudoku 2D array to store digit bitsets, passed in undefined state.
  *
  * @return true if sudoku was successfuly loaded, false otherwise.
  */
 bool load(unsigned int sudoku[9][9]);
 
+/**
+ * @brief Parse the sudoku in numeric format from one line in memory.
+ *
+ * Accepts 81 digits, where '0' or '.' is an unknown digit, optionally
+ * followed by '\r'. Nothing is printed on error.
+ *
+ * @param line the record without the newline
+ * @param length of the record
+ * @param sudoku 2D array to store digit bitsets
+ *
+ * @return true if sudoku was successfuly parsed, false otherwise.
+ */
+bool parse_line(const char *line, size_t length, unsigned int sudoku[9][9]);
+
+/** longest line of the candidate format accepted by load_candidates() */
+#define CANDIDATE_LINE 1024
+
+/**
+ * @brief Parse the sudoku in candidate format from one line in memory.
+ *
+ * Accepts either 729 chars, 9 per square, where the k-th char of a square
+ * is the digit k when it is a candidate and '.' or '0' otherwise, or 81
+ * decimal bitmasks (bit k-1 for digit k) separated by spaces, tabs or
+ * commas. Optionally followed by '\r'. The candidates are taken as they
+ * are, so eliminations made by an earlier stage are kept and the sudoku
+ * can be passed to solve() or generic_solve() directly.
+ *
+ * @param line the record without the newline
+ * @param length of the record
+ * @param sudoku 2D array to store digit bitsets
+ *
+ * @return true if sudoku was successfuly parsed, false otherwise.
+ */
+bool parse_candidates(const char *line, size_t length, unsigned int sudoku[9][9]);
+
+/**
+ * @brief Load the sudoku in candidate format from one line of STDIN.
+ *
+ * @note In case of invalid input or a line longer than CANDIDATE_LINE,
+ * prints one line message on STDERR and returns false. Shares the STDIN
+ * buffer with load(), so both can be used on the same input.
+ *
+ * @param sudoku 2D array to store digit bitsets
+ *
+ * @return true if sudoku was successfuly loaded, false otherwise.
+ */
+bool load_candidates(unsigned int sudoku[9][9]);
+
+/**
+ * @brief Write the candidates of the sudoku as one line of the 729 chars
+ * format accepted by parse_candidates(), followed by a newline.
+ *
+ * @param sudoku 2D array of digit bitsets
+ * @param line 730 chars, not null terminated
+ */
+void format_candidates(unsigned int sudoku[9][9], char line[730]);
+
 /**
  * @brief Prints sudoku to STDOUT in grid with highlighted boxes.
  *
@@ -140,6 +503,224 @@ bool load(unsigned int sudoku[9][9]);
  */
 void print(unsigned int sudoku[9][9]);
 
+/**
+ * @brief Write the sudoku as one line of the numeric format accepted by
+ * load(), i.e. 81 digits and a newline. Unknown squares are written as '0'.
+ *
+ * @param sudoku 2D array of digit bitsets
+ * @param line 82 chars, not null terminated
+ */
+void format_line(unsigned int sudoku[9][9], char line[82]);
+
+/**
+ * @brief Pack the sudoku into 41 bytes, two squares per byte with the
+ * first square in the high nibble. Unknown squares are stored as 0.
+ *
+ * @param sudoku 2D array of digit bitsets
+ * @param packed 41 bytes of output
+ */
+void pack_sudoku(unsigned int sudoku[9][9], unsigned char packed[41]);
+
+/**
+ * @brief Inverse of pack_sudoku().
+ *
+ * @param packed 41 bytes of packed sudoku
+ * @param sudoku 2D array to store digit bitsets
+ */
+void unpack_sudoku(const unsigned char packed[41], unsigned int sudoku[9][9]);
+
+/**
+ * @brief Buffered writer of solutions, zero initialize it and set the file.
+ */
+struct solution_writer {
+    /** output file */
+    FILE *file;
+    /** write 41 byte packed sudokus instead of 81 digit lines */
+    bool packed;
+    /** bytes used in the buffer */
+    size_t used;
+    unsigned char buffer[1 << 16];
+};
+
+/**
+ * @brief Append the solution to the writer, flushing it when full.
+ *
+ * Usable as callback of enumerate_solutions() with the writer as context.
+ *
+ * @param solution 2D array of digit bitsets
+ * @param writer struct solution_writer
+ *
+ * @return false on write error.
+ */
+bool write_solution(unsigned int solution[9][9], void *writer);
+
+/**
+ * @brief Write out the solutions buffered in the writer.
+ *
+ * @param writer of the solutions
+ *
+ * @return false on write error.
+ */
+bool flush_solutions(struct solution_writer *writer);
+
+/** longest line written by format_result(): the text of a solved one
+ * with its 81 digits and three numbers of at most 20 digits */
+#define RESULT_LINE (sizeof("{\"id\":,\"status\":\"solved\",\"solution\":\"\",\"nodes\":,\"time_us\":}\n") - 1 \
+                     + 81 + 3 * 20)
+
+/**
+ * @brief Outcome of solving one puzzle.
+ */
+enum result_status {
+    RESULT_SOLVED = 0,
+    /** the puzzle was read but has no solution */
+    RESULT_UNSOLVABLE,
+    /** the input is not a puzzle */
+    RESULT_INVALID,
+    /** the solver was stopped, e.g. by timeout */
+    RESULT_FAILED
+};
+
+/**
+ * @brief Metadata of a solved puzzle written by format_result().
+ */
+struct result {
+    /** identifier of the puzzle in the input */
+    unsigned long long id;
+    enum result_status status;
+    /** guesses of the search */
+    unsigned long nodes;
+    /** time of solving in microseconds */
+    unsigned long microseconds;
+};
+
+/**
+ * @brief Write the result as one JSON Lines object, without printf.
+ *
+ * @example
+ * {"id":7,"status":"solved","solution":"123...","nodes":12,"time_us":40}
+ *
+ * @param result metadata of the puzzle
+ * @param solution 2D array of digit bitsets, written only if solved
+ * @param line RESULT_LINE chars, not null terminated
+ *
+ * @return length of the line including the newline.
+ */
+size_t format_result(const struct result *result, unsigned int solution[9][9], char line[RESULT_LINE]);
+
+/**
+ * @brief Append the result to the writer, flushing it when full.
+ *
+ * @param writer of the results, its packed flag is ignored
+ * @param result metadata of the puzzle
+ * @param solution 2D array of digit bitsets, written only if solved
+ *
+ * @return false on write error.
+ */
+bool write_result(struct solution_writer *writer, const struct result *result, unsigned int solution[9][9]);
+
+/* ************************************************************** *
+ *                       Bulk verification                        *
+ * ************************************************************** */
+
+/**
+ * @brief Verify completed grids submitted as solutions of the puzzles.
+ *
+ * A solution passes when all its squares are digits 1-9, every house
+ * holds each digit once and it keeps every given of its puzzle. A puzzle
+ * with other chars than digits and '.' fails its solution. The
+ * house checks run on SSE2 vectors when available.
+ *
+ * @example
+ * records of 81 digits followed by newline have stride 82
+ *
+ * @param puzzles records of 81 ASCII digits, '0' or '.' for unknown
+ * @param solutions records of 81 ASCII digits
+ * @param stride distance between the records in bytes, at least 81
+ * @param count of the records
+ * @param passed bitmap of (count + 7) / 8 bytes, bit i % 8 of byte i / 8
+ * is set when the i-th solution passes
+ *
+ * @return count of the passed solutions.
+ */
+size_t verify_solutions(const char *puzzles, const char *solutions, size_t stride, size_t count,
+                        unsigned char *passed);
+
+/* ************************************************************** *
+ *                            Isomorphs                           *
+ * ************************************************************** */
+
+/** count of the enumerated isomorphs, 9! * 6^8 * 2 */
+#define ISOMORPH_COUNT 1218998108160ULL
+
+/**
+ * @brief Validity-preserving transformation of sudokus.
+ *
+ * Square (row, col) of the result is square (rows[row], cols[col]) of
+ * the source, transposed first if requested, and digit d becomes
+ * digits[d - 1] + 1. Rows are permuted only within bands and bands as
+ * a whole, likewise columns, so a valid sudoku stays valid and keeps
+ * its count of solutions and its difficulty.
+ */
+struct isomorph {
+    unsigned char digits[9];
+    unsigned char rows[9];
+    unsigned char cols[9];
+    bool transpose;
+};
+
+/**
+ * @brief Make random isomorph, the same seed gives the same isomorph.
+ *
+ * @param isomorph to be set
+ * @param seed of the random generator
+ */
+void isomorph_random(struct isomorph *isomorph, unsigned int seed);
+
+/**
+ * @brief Make the index-th of all ISOMORPH_COUNT isomorphs, 0 is identity.
+ *
+ * @param isomorph to be set
+ * @param index of the isomorph, taken modulo ISOMORPH_COUNT
+ */
+void isomorph_nth(struct isomorph *isomorph, unsigned long long index);
+
+/**
+ * @brief Transform the puzzle and its solution by the same isomorph,
+ * so the result needs no solving.
+ *
+ * @param isomorph the transformation
+ * @param sudoku 2D array of digit bitsets
+ * @param solution 2D array of digit bitsets, may be NULL
+ */
+void isomorph_apply(const struct isomorph *isomorph, unsigned int sudoku[9][9], unsigned int solution[9][9]);
+
+/* ************************************************************** *
+ *                         Compact solver                         *
+ * ************************************************************** */
+
+/**
+ * @brief Solve the sudoku packed by pack_sudoku() in place.
+ *
+ * Meant for devices with little RAM: besides the 41 bytes of the sudoku
+ * the search keeps only the occupancy of the houses (27 x 9 bits) and a
+ * stack of at most 81 guesses, about 260 bytes in total and no recursion.
+ * Candidates are recomputed from the occupancy whenever they are needed,
+ * so only the known digits constrain the search.
+ *
+ * @note Built with SUDOKU_COMPACT, search_solve() (and so generic_solve(),
+ * the batch driver and the command line) uses it for sudokus with no
+ * other candidates than the known digits, when neither restarts, <stop>
+ * nor <budget> are requested. Other sudokus still take the regular search.
+ *
+ * @param packed 41 bytes of packed sudoku, replaced by the solution
+ * @param guesses set to the count of cells guessed, may be NULL
+ *
+ * @return true if the sudoku has been solved, false if it has no
+ * solution; its known digits are unchanged then.
+ */
+bool compact_solve(unsigned char packed[41], unsigned long *guesses);
+
 /* ************************************************************** *
  *                              Bonus                             *
  * ************************************************************** */
@@ -149,7 +730,109 @@ void generate(unsigned int sudoku[9][9]);
 //#endif
 
 //#ifdef BONUS_GENERIC_SOLVE
+/**
+ * @brief Solve the sudoku by search_solve() with default options.
+ */
 bool generic_solve(unsigned int sudoku[9][9]);
 //#endif
 
+/**
+ * @brief Restart schedules of the backtracking search.
+ */
+enum search_restart {
+    SEARCH_RESTART_NONE = 0,
+    /** runs of restart_nodes times 1, 1, 2, 1, 1, 2, 4, ... guesses */
+    SEARCH_RESTART_LUBY,
+    /** runs of restart_nodes guesses, growing by half each time */
+    SEARCH_RESTART_GEOMETRIC
+};
+
+/**
+ * @brief Orders in which the backtracking search tries the digits.
+ *
+ * With restarts the ascending and descending orders are replaced by a
+ * random order, so the runs differ; the other orders keep their scores
+ * and only their ties are broken randomly.
+ */
+enum search_value_order {
+    /** digits from 1 to 9, random with restarts */
+    SEARCH_VALUE_ASCENDING = 0,
+    /** digits from 9 to 1, random with restarts */
+    SEARCH_VALUE_DESCENDING,
+    /** digits present in the fewest unknown peers first */
+    SEARCH_VALUE_LEAST_CONSTRAINING,
+    /** digits with the fewest places in some house of the cell first */
+    SEARCH_VALUE_PEER_FREQUENCY,
+    /** digits which failed the least often in this cell during the search first */
+    SEARCH_VALUE_LEARNED
+};
+
+/**
+ * @brief Options of the backtracking search.
+ *
+ * Zero initialized options give the behaviour of generic_solve().
+ */
+struct search_options {
+    /** branch on the cell with fewest candidates, not the first unknown one */
+    bool fewest_candidates;
+    /** order in which the digits of the branching cell are tried */
+    enum search_value_order value_order;
+    /** restart schedule; restarts randomize the branching cell and digit order */
+    enum search_restart restart;
+    /** guesses in the first run, 0 for default of 100 */
+    unsigned long restart_nodes;
+    /** seed of the randomized branching, same seed gives the same search */
+    unsigned int seed;
+    /** polled during the search, returning true abandons it (may be NULL) */
+    bool (*stop)(void *context);
+    /** passed to <stop> */
+    void *context;
+    /** if not NULL, set to the count of guesses when the search ends; only
+     * the thread running the search may read it meanwhile */
+    unsigned long *nodes;
+    /** guesses allowed before the search gives up, 0 for unlimited */
+    unsigned long budget;
+    /** arena for the state of the search, NULL or full for the C stack */
+    struct arena *arena;
+};
+
+/**
+ * @brief Solve the sudoku using backtracking and elimination with
+ * the given options.
+ *
+ * @note Returns false also when the search was abandoned by <stop>.
+ *
+ * @param sudoku 2D array of digit bitsets
+ * @param options of the search, NULL for defaults
+ */
+bool search_solve(unsigned int sudoku[9][9], const struct search_options *options);
+
+/**
+ * @brief Enumerate the solutions of the sudoku with a single search.
+ *
+ * @param sudoku 2D array of digit bitsets, it is left unchanged
+ * @param limit of the solutions, 0 for unlimited
+ * @param callback called with each solution, returning false stops
+ * the enumeration; NULL only counts the solutions
+ * @param context passed to the callback
+ *
+ * @return count of solutions found.
+ */
+unsigned long enumerate_solutions(unsigned int sudoku[9][9], unsigned long limit,
+                                  bool (*callback)(unsigned int solution[9][9], void *context), void *context);
+
+/**
+ * @brief Compute the backbone of the sudoku, i.e. cells which have the
+ * same value in all its solutions, without enumerating the solutions.
+ *
+ * On return the backbone cells hold their value and every other cell
+ * holds at least two digits seen in different solutions.
+ *
+ * @param sudoku 2D array of digit bitsets
+ *
+ * @return count of backbone cells (givens included), -1 if the sudoku
+ * has no solution.
+ */
+int backbone(unsigned int sudoku[9][9]);
+
 #endif //SUDOKU_H
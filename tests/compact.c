@@ -0,0 +1,120 @@
+/**
+ * @file compact.c
+ * @brief Check of compact_solve() against search_solve().
+ *
+ * Build and run from the root of the repository:
+ *
+ *     cc -std=c99 -O2 -o check_compact tests/compact.c sudoku.c
+ *     ./check_compact [count]
+ *
+ * Build it without SUDOKU_COMPACT, which routes search_solve() itself to
+ * the compact solver. Exit status is 0 if all checks pass.
+ */
+
+#include "../sudoku.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief           Make the puzzle generated from the seed, the same as
+ *                  <batch_generate_file()> makes.
+ *
+ * @param sudoku    sudoku in 2D format
+ * @param seed      seed of the puzzle
+ *
+ * @return          None
+ */
+static void make_puzzle(unsigned int sudoku[9][9], unsigned int seed)
+{
+    const struct search_options random = { .restart = SEARCH_RESTART_LUBY, .seed = seed };
+    for (int i = 0; i < 81; i++) {
+        ((unsigned int *) sudoku)[i] = 0x1ff;
+    }
+    search_solve(sudoku, &random);
+    srand(seed);
+    generate(sudoku);
+}
+
+/**
+ * @brief           Solve the puzzle by both solvers and compare them.
+ *
+ * @param line      the puzzle, 81 digits
+ * @param expected  puzzle has a solution
+ *
+ * @return          solvers agree with <expected> and with each other -> true
+ *                  otherwise -> false
+ */
+static bool check_puzzle(const char *line, bool expected)
+{
+    unsigned int sudoku[9][9], searched[9][9], compact[9][9];
+    unsigned char packed[41], original[41];
+    if (!parse_line(line, 81, sudoku)) {
+        return false;
+    }
+    memcpy(searched, sudoku, sizeof(sudoku));
+    pack_sudoku(sudoku, packed);
+    memcpy(original, packed, sizeof(packed));
+
+    bool solved = compact_solve(packed, NULL);
+    if (solved != expected || search_solve(searched, NULL) != expected) {
+        return false;
+    }
+    if (!solved) {
+        /* the known digits must be left as they were */
+        return memcmp(packed, original, sizeof(packed)) == 0;
+    }
+    unpack_sudoku(packed, compact);
+    for (int i = 0; i < 81; i++) {
+        unsigned int given = ((unsigned int *) sudoku)[i];
+        if ((((unsigned int *) compact)[i] & given) == 0) {
+            return false;
+        }
+    }
+    return is_valid(compact) && !needs_solving(compact) && memcmp(compact, searched, sizeof(compact)) == 0;
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned int count = argc > 1 ? (unsigned int) strtoul(argv[1], NULL, 10) : 300;
+    int failed = 0;
+    for (unsigned int seed = 1; seed <= count; seed++) {
+        unsigned int sudoku[9][9];
+        char line[82];
+        make_puzzle(sudoku, seed);
+        format_line(sudoku, line);
+        if (!check_puzzle(line, true)) {
+            printf("generated puzzle %u: %.81s\n", seed, line);
+            failed++;
+        }
+    }
+    /* the last square of the first row can only hold 9, which its column already has */
+    if (!check_puzzle("123456780"
+                      "000000009"
+                      "000000000"
+                      "000000000"
+                      "000000000"
+                      "000000000"
+                      "000000000"
+                      "000000000"
+                      "000000000",
+                      false)) {
+        printf("unsolvable puzzle\n");
+        failed++;
+    }
+    if (!check_puzzle("110000000"
+                      "000000000"
+                      "000000000"
+                      "000000000"
+                      "000000000"
+                      "000000000"
+                      "000000000"
+                      "000000000"
+                      "000000000",
+                      false)) {
+        printf("puzzle with a repeated digit\n");
+        failed++;
+    }
+    printf("%u generated puzzles, %d failed\n", count, failed);
+    return failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
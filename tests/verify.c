@@ -0,0 +1,81 @@
+/**
+ * @file verify.c
+ * @brief Check of verify_solutions() on valid and corrupted records.
+ *
+ * Build and run from the root of the repository:
+ *
+ *     cc -std=c99 -O2 -o check_verify tests/verify.c sudoku.c
+ *     ./check_verify
+ *
+ * Exit status is 0 if all checks pass.
+ */
+
+#include "../sudoku.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char SOLUTION[] = "417369825632158947958724316825437169791586432346912758289643571573291684164875293";
+static const char PUZZLE[] = "400000805030000000000700000020000060000080400000010000000603070500200000104000000";
+
+/**
+ * @brief           Verify one record by <verify_solutions()>.
+ *
+ * @param puzzle    81 chars of the puzzle
+ * @param solution  81 chars of the solution
+ *
+ * @return          solution passes -> true
+ *                  otherwise -> false
+ */
+static bool passes(const char *puzzle, const char *solution)
+{
+    unsigned char passed[1];
+    return verify_solutions(puzzle, solution, 81, 1, passed) == 1 && (passed[0] & 1) != 0;
+}
+
+/**
+ * @brief           Copy the record and put the char at the position.
+ *
+ * @param record    81 chars of the record
+ * @param copy      array for the copy
+ * @param position  index of the changed char
+ * @param chr       the new char
+ *
+ * @return          the copy
+ */
+static const char *corrupt(const char *record, char copy[82], int position, char chr)
+{
+    memcpy(copy, record, 82);
+    copy[position] = chr;
+    return copy;
+}
+
+int main(void)
+{
+    char puzzle[82], solution[82];
+    int failed = 0;
+    const struct {
+        const char *name;
+        bool expected;
+        bool actual;
+    } checks[] = {
+        { "valid solution", true, passes(PUZZLE, SOLUTION) },
+        { "unknowns as '.'", true, passes(corrupt(PUZZLE, puzzle, 1, '.'), SOLUTION) },
+        { "given in the last square", true, passes(corrupt(PUZZLE, puzzle, 80, '3'), SOLUTION) },
+        { "corrupted puzzle", false, passes(corrupt(PUZZLE, puzzle, 5, 'x'), SOLUTION) },
+        { "corrupted last square of the puzzle", false, passes(corrupt(PUZZLE, puzzle, 80, ' '), SOLUTION) },
+        { "puzzle of spaces", false, passes("                                                                                 ",
+                                             SOLUTION) },
+        { "changed given", false, passes(PUZZLE, corrupt(SOLUTION, solution, 0, '5')) },
+        { "solution with '0'", false, passes(PUZZLE, corrupt(SOLUTION, solution, 1, '0')) },
+        { "solution with a letter", false, passes(PUZZLE, corrupt(SOLUTION, solution, 80, 'a')) },
+    };
+    for (size_t i = 0; i < sizeof(checks) / sizeof(checks[0]); i++) {
+        if (checks[i].expected != checks[i].actual) {
+            printf("%s: expected %s\n", checks[i].name, checks[i].expected ? "pass" : "fail");
+            failed++;
+        }
+    }
+    printf("%zu checks, %d failed\n", sizeof(checks) / sizeof(checks[0]), failed);
+    return failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}